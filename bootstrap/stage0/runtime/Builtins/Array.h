@@ -4,6 +4,7 @@
 #include <Jakt/Error.h>
 #include <Jakt/RefCounted.h>
 #include <Jakt/RefPtr.h>
+#include <Jakt/kmalloc.h>
 #include <Builtins/Range.h>
 #include <initializer_list>
 #include <stdlib.h>
@@ -15,14 +16,15 @@ template<typename T>
 class ArraySlice;
 
 template<typename T>
-class ArrayStorage : public RefCounted<ArrayStorage<T>> {
+class ArrayStorage : public RefCounted<ArrayStorage<T>>
+    , public SlabAllocated {
 public:
     ArrayStorage() { }
 
     ~ArrayStorage()
     {
         shrink(0);
-        free(m_elements);
+        kfree_slab(m_elements, m_capacity * sizeof(T));
     }
 
     bool is_empty() const { return m_size == 0; }
@@ -37,7 +39,7 @@ public:
         if (Checked<size_t>::multiplication_would_overflow(capacity, sizeof(T))) {
             return Error::from_errno(EOVERFLOW);
         }
-        auto* new_elements = static_cast<T*>(malloc(capacity * sizeof(T)));
+        auto* new_elements = static_cast<T*>(kmalloc_slab(capacity * sizeof(T)));
         if (!new_elements) {
             return Error::from_errno(ENOMEM);
         }
@@ -45,7 +47,7 @@ public:
             new (&new_elements[i]) T(move(m_elements[i]));
             m_elements[i].~T();
         }
-        free(m_elements);
+        kfree_slab(m_elements, m_capacity * sizeof(T));
         m_elements = new_elements;
         m_capacity = capacity;
         return {};
@@ -15,7 +15,8 @@ namespace JaktInternal {
 using namespace Jakt;
 
 template<typename K, typename V>
-struct DictionaryStorage : public RefCounted<DictionaryStorage<K, V>> {
+struct DictionaryStorage : public RefCounted<DictionaryStorage<K, V>>
+    , public SlabAllocated {
     HashMap<K, V> map;
 };
 
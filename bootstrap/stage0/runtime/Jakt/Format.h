@@ -450,6 +450,12 @@ ErrorOr<void> vformat(StringBuilder&, StringView fmtstr, TypeErasedFormatParams&
 #ifndef KERNEL
 void vout(FILE*, StringView fmtstr, TypeErasedFormatParams&, bool newline = false);
 
+// Gives stdout a large buffer: line-buffered when it's a terminal, block-buffered otherwise. stderr stays
+// unbuffered, so nothing written to it is lost if the process dies without exiting. Anything still buffered is
+// written out at exit, by flush_output(), and before a panic or failed VERIFY.
+void set_up_output_buffering();
+void flush_output();
+
 template<typename... Parameters>
 void out(FILE* file, StringView&& fmtstr, Parameters const&... parameters)
 {
@@ -197,11 +197,6 @@ bool String::operator==(char const* c_string) const
     return view() == c_string;
 }
 
-void StringStorage::operator delete(void* ptr)
-{
-    free(ptr);
-}
-
 static StringStorage* s_the_empty_string_storage = nullptr;
 
 StringStorage& StringStorage::the_empty_string()
@@ -227,10 +222,17 @@ constexpr size_t allocation_size_for_string_storage(size_t length)
     return sizeof(StringStorage) + (sizeof(char) * length) + sizeof(char);
 }
 
+void StringStorage::operator delete(StringStorage* ptr, std::destroying_delete_t)
+{
+    auto size = allocation_size_for_string_storage(ptr->length());
+    ptr->~StringStorage();
+    kfree_slab(ptr, size);
+}
+
 ErrorOr<NonnullRefPtr<StringStorage>> StringStorage::create_uninitialized(size_t length, char*& buffer)
 {
     VERIFY(length);
-    void* slot = malloc(allocation_size_for_string_storage(length));
+    void* slot = kmalloc_slab(allocation_size_for_string_storage(length));
     if (!slot) {
         return Error::from_errno(ENOMEM);
     }
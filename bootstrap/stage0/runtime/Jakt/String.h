@@ -24,7 +24,8 @@ public:
     static ErrorOr<NonnullRefPtr<StringStorage>> create_uninitialized(size_t length, char*& buffer);
     static ErrorOr<NonnullRefPtr<StringStorage>> create(char const* c_string, size_t length);
 
-    void operator delete(void* ptr);
+    // Gives the storage back to kfree_slab(), which needs the size it was allocated with.
+    void operator delete(StringStorage* ptr, std::destroying_delete_t);
 
     static StringStorage& the_empty_string();
 
@@ -47,4 +47,30 @@ inline void* kmalloc_array(Checked<size_t> a, Checked<size_t> b, Checked<size_t>
     VERIFY(!size.has_overflow());
     return kmalloc(size.value());
 }
+
+#ifndef KERNEL
+// Small fixed-size runtime objects (string, array, dictionary and set storage, boxed enum nodes, short array
+// buffers) are allocated from per-thread free lists, one for each 16-byte size class up to 256 bytes; larger
+// requests go to malloc. A block can be freed by any thread, onto that thread's lists.
+// Setting JAKT_SLAB_ALLOCATOR=0 in the environment sends everything to malloc (e.g. for memory checkers), and
+// setting JAKT_ALLOC_STATS=1 prints per-size-class counts to stderr at exit.
+void* kmalloc_slab(size_t size);
+void kfree_slab(void* ptr, size_t size);
+
+// Gives a class operator new and delete that go through kmalloc_slab() and kfree_slab().
+class SlabAllocated {
+public:
+    void* operator new(size_t size)
+    {
+        auto* ptr = kmalloc_slab(size);
+        VERIFY(ptr);
+        return ptr;
+    }
+    void* operator new(size_t size, std::nothrow_t const&) noexcept { return kmalloc_slab(size); }
+    void* operator new(size_t, void* where) noexcept { return where; }
+
+    void operator delete(void* ptr, size_t size) noexcept { kfree_slab(ptr, size); }
+    void operator delete(void*, void*) noexcept { }
+};
+#endif
 }
@@ -82,9 +82,15 @@ inline void panic(StringView message)
 
 [[noreturn]] inline void abort()
 {
+    flush_output();
     ::abort();
 }
 
+inline void flush()
+{
+    flush_output();
+}
+
 template<typename T>
 inline constexpr T unchecked_add(T value, T other)
 {
@@ -299,6 +305,7 @@ ALWAYS_INLINE decltype(auto) deref_if_ref_pointer(T&& value)
 
 namespace Jakt {
 using JaktInternal::abort;
+using JaktInternal::flush;
 using JaktInternal::as_saturated;
 using JaktInternal::as_truncated;
 using JaktInternal::fallible_integer_cast;
@@ -45,7 +45,7 @@ foreach (stage IN LISTS stages)
 endforeach()
 
 install(
-    TARGETS jakt_runtime
+    TARGETS jakt_runtime jakt_runtime_atomic
     EXPORT JaktTargets
     RUNTIME #
         DESTINATION "${CMAKE_INSTALL_BINDIR}"
@@ -60,7 +60,7 @@ install(
 )
 
 install(
-    TARGETS jakt_main
+    TARGETS jakt_main jakt_main_atomic
     EXPORT JaktTargets
     RUNTIME #
         DESTINATION "${CMAKE_INSTALL_BINDIR}"
@@ -9,8 +9,8 @@
 #include <Jakt/RefPtr.h>
 #include <time.h>
 #ifndef _WIN32
+#include <Process/Process.h>
 #include <signal.h>
-#include <sys/wait.h>
 #else
 #define WIN32_LEAN_AND_MEAN
 #include <windows.h>
@@ -21,108 +21,39 @@
 namespace Jakt::process {
 
 #ifndef _WIN32
-// Allocates & fills one array, which contains:
-// - the argv array with all the pointers into later offsets of the array, at the front
-// - the string arguments that follow the last argv NULL pointer, terminated by zeroes.
-static ErrorOr<char**> dup_argv(Array<String> args)
+static ExitPollResult exit_poll_result(ExitStatus status)
 {
-
-    // 1. Calculate the total size  of all the pointers + all the strings, accounting
-    // for the last NULL pointer and each argument's NUL terminator.
-    auto const argv_size = Checked(args.size()) + Checked<size_t>(1ul);
-    auto const argv_malloc_size = argv_size * Checked(sizeof(char*));
-    // ensure argv malloc size has no overflow because we're going to use it
-    // as the offset for the start of the string array.
-    if (argv_malloc_size.has_overflow()) {
-        return Error::from_errno(EOVERFLOW);
-    }
-
-    // join all the strings in one allocation
-    auto total_string_size = Checked<size_t>(0);
-    for (size_t i = 0; i != args.size(); ++i) {
-        total_string_size += args[i].length();
-    }
-    total_string_size += args.size();
-
-    auto const total_allocation_size = argv_malloc_size + total_string_size;
-    if (total_allocation_size.has_overflow()) {
-        return Error::from_errno(EOVERFLOW);
-    }
-
-    // 2. Allocate the full array
-    auto const full_array = malloc(total_allocation_size.value_unchecked());
-    if (!full_array) {
-        return Error::from_errno(ENOMEM);
-    }
-
-    // 3. Fill all strings & argv offsets.
-    // NOTE: argv *is* the start of the allocation, so any free()s to this data structure must point to `argv`.
-    auto const argv = reinterpret_cast<char**>(full_array);
-
-    {
-        char* arg = reinterpret_cast<char*>(full_array) + argv_malloc_size.value_unchecked();
-        for (u64 i = 0; i != args.size(); ++i) {
-            // copy the string
-            memcpy(arg, args[i].c_string(), args[i].length());
-            arg[args[i].length()] = 0;
-            // set the argument pointer
-            argv[i] = arg;
-            // add the offset
-            arg += args[i].length() + 1;
-        }
-        argv[args.size()] = NULL;
-    }
-
-    return argv;
+    return ExitPollResult { status.exit_code(), status.pid() };
 }
 
 ErrorOr<i32> start_background_process(Array<String> args)
 {
-    // We have to fully duplicate argv because execvp wants
-    // *modifiable* arguments (char* const*)
-    auto const argv = TRY(dup_argv(args));
-    auto const pid = fork();
-    if (pid == -1) {
-        return Error::from_errno(errno);
-    }
-    if (pid == 0) {
-        // child process, execute the command
-        execvp(argv[0], argv);
-    }
-
-    // Allocated memory got dup'd, so we'll free the parent side.
-    // NOTE: See point 3 on dup_argv
-    free(argv);
-
-    return pid;
+    return spawn_process(move(args), {}, {}, {});
 }
 
 ErrorOr<Optional<ExitPollResult>> poll_process_exit(i32 pid)
 {
-    i32 wstatus;
-    auto const result = waitpid(pid, &wstatus, WNOHANG);
-    if (result == -1) {
+    auto result = poll_for_exit(pid);
+    if (result.is_error()) {
         // no children
-        if (errno == ECHILD) {
+        if (result.error().code() == ECHILD)
             return JaktInternal::NullOptional {};
-        }
-        return Error::from_errno(errno);
+        return result.release_error();
     }
-    // not exited.
-    if (result == 0) {
+    auto status = result.release_value();
+    if (!status.has_value())
         return JaktInternal::NullOptional {};
-    }
-    // NOTE: compiler seems to struggle to find a constructor when
-    // nesting error & optional
-    return Optional<ExitPollResult>(ExitPollResult { WEXITSTATUS(wstatus), result });
+    return Optional<ExitPollResult>(exit_poll_result(status.value()));
+}
+
+ErrorOr<ExitPollResult> wait_for_any_process_exit()
+{
+    return exit_poll_result(TRY(wait_for_exit(-1)));
 }
 
 ErrorOr<void> forcefully_kill_process(i32 pid)
 {
-    if (kill(pid, SIGKILL) < 0) {
-        return Error::from_errno(errno);
-    }
-    return ErrorOr<void> {};
+    return kill_process(pid, SIGKILL);
 }
 #else
 
@@ -254,6 +185,17 @@ ErrorOr<Optional<ExitPollResult>> poll_process_exit(i32 pid)
     return ExitPollResult { static_cast<i32>(maybe_exit_code.value()), pid };
 }
 
+ErrorOr<ExitPollResult> wait_for_any_process_exit()
+{
+    if (s_process_handles.is_empty())
+        return Error::from_errno(ECHILD);
+    while (true) {
+        auto exited = TRY(poll_any_process(INFINITE));
+        if (exited.has_value())
+            return exited.release_value();
+    }
+}
+
 ErrorOr<void> forcefully_kill_process(i32 pid)
 {
     auto it = s_process_handles.find(pid);
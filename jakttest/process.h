@@ -26,5 +26,7 @@ public:
 };
 ErrorOr<i32> start_background_process(Array<String> args);
 ErrorOr<Optional<ExitPollResult>> poll_process_exit(i32 pid);
+// Blocks until any child process exits.
+ErrorOr<ExitPollResult> wait_for_any_process_exit();
 ErrorOr<void> forcefully_kill_process(i32 pid);
 }
@@ -0,0 +1,106 @@
+#!/usr/bin/env bash
+
+# Times a program that churns the runtime's small objects (short strings, small arrays and dictionaries, boxed
+# enum nodes), built by each of the given compilers, with the runtime's size-class allocator on (the default),
+# off (JAKT_SLAB_ALLOCATOR=0, plain malloc), and with each round run inside a jakt::arena with_arena() body.
+# Pass -s to also print the allocator's per-size-class counts.
+#
+# Usage: meta/benchmark_alloc.sh [-n runs] [-r rounds] [-s] compiler...
+# e.g.   meta/benchmark_alloc.sh -n 5 -r 2000 build/bin/jakt_stage1
+
+set -e
+
+runs=5
+rounds=1000
+stats=0
+while [ $# -gt 0 ]; do
+    case "$1" in
+        -n) runs="$2"; shift 2 ;;
+        -r) rounds="$2"; shift 2 ;;
+        -s) stats=1; shift ;;
+        *) break ;;
+    esac
+done
+
+if [ $# -eq 0 ]; then
+    set -- build/bin/jakt_stage1
+fi
+
+repo_root="$(cd "$(dirname "${BASH_SOURCE[0]}")/.." && pwd)"
+scratch="$(mktemp -d)"
+trap 'rm -rf "$scratch"' EXIT
+
+cat > "$scratch/alloc_benchmark.jakt" <<JAKT
+import jakt::arena { with_arena }
+
+boxed enum Tree {
+    Leaf(i64)
+    Node(left: Tree, right: Tree)
+}
+
+function build(depth: i64, seed: i64) throws -> Tree {
+    if depth == 0 {
+        return Tree::Leaf(seed)
+    }
+    return Tree::Node(left: build(depth: depth - 1, seed: seed * 2), right: build(depth: depth - 1, seed: seed * 2 + 1))
+}
+
+function sum(anon tree: Tree) -> i64 => match tree {
+    Leaf(value) => value
+    Node(left, right) => sum(left) + sum(right)
+}
+
+function churn(round: i64) throws -> i64 {
+    mut words: [String] = []
+    mut counts: [String:i64] = [:]
+    for i in 0..1000 {
+        let word = format("w{}", (i * 7 + round) % 300)
+        words.push(word)
+        counts.set(word, counts.get(word).value_or(0) + 1)
+    }
+    mut pairs: [[i64]] = []
+    for i in 0..500 {
+        pairs.push([i, round])
+    }
+    return words.size() as! i64 + counts.size() as! i64 + pairs.size() as! i64 + sum(build(depth: 10, seed: round))
+}
+
+function main(args: [String]) {
+    let use_arena = args.size() > 1 and args[1] == "arena"
+    mut checksum = 0
+    for round in 0..${rounds} {
+        if use_arena {
+            with_arena(&function[&mut checksum, round]() throws {
+                checksum += churn(round)
+            })
+        } else {
+            checksum += churn(round)
+        }
+    }
+    println("{}", checksum)
+}
+JAKT
+
+cd "$repo_root"
+for compiler in "$@"; do
+    binary_dir="$scratch/build-$(basename "$compiler")"
+    "$compiler" -O -B "$binary_dir" -o alloc_benchmark "$scratch/alloc_benchmark.jakt"
+    for allocator in slab malloc arena; do
+        setting=1
+        if [ "$allocator" = malloc ]; then
+            setting=0
+        fi
+        times=()
+        for ((i = 0; i < runs; i++)); do
+            start=$(date +%s%N)
+            JAKT_SLAB_ALLOCATOR=$setting "$binary_dir/alloc_benchmark" "$allocator" > /dev/null
+            end=$(date +%s%N)
+            times+=($(( (end - start) / 1000000 )))
+        done
+        sorted=($(printf '%s\n' "${times[@]}" | sort -n))
+        echo "$compiler: $allocator, $rounds rounds, min ${sorted[0]} ms, median ${sorted[$((runs / 2))]} ms over $runs runs"
+    done
+    if [ "$stats" = 1 ]; then
+        JAKT_ALLOC_STATS=1 "$binary_dir/alloc_benchmark" arena > /dev/null
+    fi
+done
@@ -0,0 +1,74 @@
+#!/usr/bin/env bash
+
+# Times building (Jakt and C++) a module made of large sum enums and matches over them, for each of the given
+# compilers, so the cost of the generated enum layout can be compared between them.
+#
+# Usage: meta/benchmark_enum_compile.sh [-n runs] [-e enums] [-v variants] compiler...
+# e.g.   meta/benchmark_enum_compile.sh -n 3 -v 100 build/bin/jakt_stage1 /usr/local/bin/jakt
+
+set -e
+
+runs=3
+enums=20
+variants=40
+while [ $# -gt 0 ]; do
+    case "$1" in
+        -n) runs="$2"; shift 2 ;;
+        -e) enums="$2"; shift 2 ;;
+        -v) variants="$2"; shift 2 ;;
+        *) break ;;
+    esac
+done
+
+if [ $# -eq 0 ]; then
+    set -- build/bin/jakt_stage1
+fi
+
+repo_root="$(cd "$(dirname "${BASH_SOURCE[0]}")/.." && pwd)"
+scratch="$(mktemp -d)"
+trap 'rm -rf "$scratch"' EXIT
+
+source="$scratch/enum_benchmark.jakt"
+{
+    for ((e = 0; e < enums; e++)); do
+        echo "enum Enum$e {"
+        for ((v = 0; v < variants; v++)); do
+            case $((v % 3)) in
+                0) echo "    Plain$v" ;;
+                1) echo "    Typed$v(i64)" ;;
+                2) echo "    Named$v(name: String, value: i64)" ;;
+            esac
+        done
+        echo "}"
+        echo "function weigh$e(anon value: Enum$e) -> i64 => match value {"
+        for ((v = 0; v < variants; v++)); do
+            case $((v % 3)) in
+                0) echo "    Plain$v => $v" ;;
+                1) echo "    Typed$v(x) => x + $v" ;;
+                2) echo "    Named$v(name, value) => value + name.length() as! i64" ;;
+            esac
+        done
+        echo "}"
+    done
+    echo "function main() {"
+    echo "    mut total = 0"
+    for ((e = 0; e < enums; e++)); do
+        echo "    total += weigh$e(Enum$e::Typed1(1))"
+    done
+    echo "    println(\"{}\", total)"
+    echo "}"
+} > "$source"
+
+cd "$repo_root"
+for compiler in "$@"; do
+    times=()
+    for ((i = 0; i < runs; i++)); do
+        binary_dir="$scratch/build-$(basename "$compiler")-$i"
+        start=$(date +%s%N)
+        "$compiler" -B "$binary_dir" -o enum_benchmark "$source" > /dev/null 2>&1
+        end=$(date +%s%N)
+        times+=($(( (end - start) / 1000000 )))
+    done
+    sorted=($(printf '%s\n' "${times[@]}" | sort -n))
+    echo "$compiler: $enums enums of $variants variants, min ${sorted[0]} ms, median ${sorted[$((runs / 2))]} ms over $runs runs"
+done
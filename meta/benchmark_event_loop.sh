@@ -0,0 +1,177 @@
+#!/usr/bin/env bash
+
+# Measures the throughput of the runtime's event loop (jakt::event_loop) on one thread. Each of `streams`
+# connections sends `size` bytes through the loop and gets them echoed back, over pipes (one each way), socket
+# pairs and connections to a listening Unix socket; a single stream shows the per-byte cost, many show the cost
+# of multiplexing.
+#
+# Usage: meta/benchmark_event_loop.sh [-n runs] [-s bytes-per-stream] [-c "stream counts"] [-C cxx-compiler] [library-dir]
+# e.g.   meta/benchmark_event_loop.sh -n 5 -s 1048576 -c "1 100 1000" build/lib
+
+set -e
+
+runs=5
+size=1048576
+stream_counts="1 100 1000"
+cxx=c++
+while [ $# -gt 0 ]; do
+    case "$1" in
+        -n) runs="$2"; shift 2 ;;
+        -s) size="$2"; shift 2 ;;
+        -c) stream_counts="$2"; shift 2 ;;
+        -C) cxx="$2"; shift 2 ;;
+        *) break ;;
+    esac
+done
+
+repo_root="$(cd "$(dirname "${BASH_SOURCE[0]}")/.." && pwd)"
+library_dir="$(cd "${1:-$repo_root/build/lib}" && pwd)"
+scratch="$(mktemp -d)"
+trap 'rm -rf "$scratch"' EXIT
+
+cat > "$scratch/event_loop_benchmark.cpp" <<'CPP'
+#include <IO/EventLoop.h>
+#include <algorithm>
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace Jakt;
+
+static constexpr size_t chunk_size = 64 * 1024;
+static size_t s_received;
+static size_t s_finished;
+
+// Writes `remaining` bytes one chunk at a time, each once the previous one has drained, then ends the stream.
+static ErrorOr<void> send(NonnullRefPtr<Stream> out, size_t remaining)
+{
+    while (remaining > 0 && out->buffered_size() == 0) {
+        auto chunk = TRY(Array<u8>::create_empty());
+        TRY(chunk.resize(min(remaining, chunk_size)));
+        remaining -= chunk.size();
+        TRY(out->write(move(chunk)));
+    }
+    if (remaining == 0)
+        return out->end();
+    return out->on_drained([out, remaining]() { return send(out, remaining); });
+}
+
+// Writes everything `in` receives to `out`, and ends `out` when `in` ends.
+static ErrorOr<void> echo(NonnullRefPtr<Stream> in, NonnullRefPtr<Stream> out)
+{
+    return in->start_reading(
+        [out](Array<u8> bytes) { return out->write(move(bytes)); },
+        [in, out]() -> ErrorOr<void> {
+            TRY(out->end());
+            return in->close();
+        });
+}
+
+static ErrorOr<void> receive(NonnullRefPtr<Stream> in)
+{
+    return in->start_reading(
+        [](Array<u8> bytes) -> ErrorOr<void> {
+            s_received += bytes.size();
+            return {};
+        },
+        [in]() -> ErrorOr<void> {
+            ++s_finished;
+            return in->close();
+        });
+}
+
+// Each stream is a pipe there and a pipe back.
+static ErrorOr<void> start_pipes(NonnullRefPtr<EventLoop> loop, size_t streams, size_t size)
+{
+    for (size_t i = 0; i < streams; ++i) {
+        auto there = TRY(open_pipe(loop));
+        auto back = TRY(open_pipe(loop));
+        TRY(echo(there.get<0>(), back.get<1>()));
+        TRY(receive(back.get<0>()));
+        TRY(send(there.get<1>(), size));
+    }
+    return {};
+}
+
+static ErrorOr<void> start_socket_pairs(NonnullRefPtr<EventLoop> loop, size_t streams, size_t size)
+{
+    for (size_t i = 0; i < streams; ++i) {
+        auto pair = TRY(open_socket_pair(loop));
+        TRY(echo(pair.get<1>(), pair.get<1>()));
+        TRY(receive(pair.get<0>()));
+        TRY(send(pair.get<0>(), size));
+    }
+    return {};
+}
+
+static ErrorOr<void> start_unix_connections(NonnullRefPtr<EventLoop> loop, size_t streams, size_t size, String const& path, RefPtr<Listener>& listener)
+{
+    listener = TRY(Listener::listen_unix(loop, path, [](NonnullRefPtr<Stream> connection) { return echo(connection, connection); }));
+    for (size_t i = 0; i < streams; ++i) {
+        auto client = TRY(connect_unix(loop, path));
+        TRY(receive(client));
+        TRY(send(client, size));
+        // Accept as we go, so the listen backlog doesn't fill up.
+        (void)TRY(loop->run_once(0));
+    }
+    return {};
+}
+
+int main(int argc, char** argv)
+{
+    size_t size = strtoul(argv[1], nullptr, 10);
+    size_t streams = strtoul(argv[2], nullptr, 10);
+    int runs = atoi(argv[3]);
+    auto path = MUST(String::copy(StringView { argv[4], strlen(argv[4]) }));
+
+    // Two streams per connection, each with up to three fds.
+    struct rlimit limit;
+    getrlimit(RLIMIT_NOFILE, &limit);
+    limit.rlim_cur = limit.rlim_max;
+    setrlimit(RLIMIT_NOFILE, &limit);
+
+    char const* names[] = { "pipes", "socket pairs", "unix socket" };
+    for (int kind = 0; kind < 3; ++kind) {
+        std::vector<double> times;
+        for (int run = 0; run < runs; ++run) {
+            s_received = 0;
+            s_finished = 0;
+            auto loop = MUST(EventLoop::create());
+            RefPtr<Listener> listener;
+            auto start = std::chrono::steady_clock::now();
+            if (kind == 0)
+                MUST(start_pipes(loop, streams, size));
+            else if (kind == 1)
+                MUST(start_socket_pairs(loop, streams, size));
+            else
+                MUST(start_unix_connections(loop, streams, size, path, listener));
+            while (s_finished < streams)
+                (void)MUST(loop->run_once(-1));
+            auto end = std::chrono::steady_clock::now();
+            if (listener)
+                MUST(listener->close());
+            if (s_received != streams * size) {
+                fprintf(stderr, "%s: received %zu bytes instead of %zu\n", names[kind], s_received, streams * size);
+                return 1;
+            }
+            times.push_back(std::chrono::duration<double>(end - start).count());
+        }
+        std::sort(times.begin(), times.end());
+        double median = times[times.size() / 2];
+        double megabytes = 2.0 * streams * size / (1024 * 1024);
+        printf("%-12s %5zu streams x %zu bytes echoed: %8.1f ms, %8.1f MiB/s through the loop (median of %d runs)\n",
+            names[kind], streams, size, median * 1000, megabytes / median, runs);
+    }
+    unlink(argv[4]);
+    return 0;
+}
+CPP
+
+"$cxx" -std=c++20 -fno-exceptions -O2 -Wno-user-defined-literals -I "$repo_root/runtime" \
+    -o "$scratch/event_loop_benchmark" "$scratch/event_loop_benchmark.cpp" "$library_dir/libjakt_runtime.a"
+for streams in $stream_counts; do
+    "$scratch/event_loop_benchmark" "$size" "$streams" "$runs" "$scratch/benchmark.sock"
+done
@@ -0,0 +1,191 @@
+#!/usr/bin/env bash
+
+# Compares the runtime's string and integer hashes with the byte-at-a-time Jenkins hash and the shift/xor integer
+# hash they replaced: throughput over strings of a few lengths and over integers, and quality as the number of
+# keys that land in an already-taken slot of a power-of-two table (which is all the hash table uses) and the
+# worst bias of any output bit when flipping one input bit.
+#
+# Usage: meta/benchmark_hash.sh [-n runs] [-s size] [-C cxx-compiler]
+# e.g.   meta/benchmark_hash.sh -n 5 -s 1000000
+
+set -e
+
+runs=5
+size=1000000
+cxx=c++
+while [ $# -gt 0 ]; do
+    case "$1" in
+        -n) runs="$2"; shift 2 ;;
+        -s) size="$2"; shift 2 ;;
+        -C) cxx="$2"; shift 2 ;;
+        *) break ;;
+    esac
+done
+
+repo_root="$(cd "$(dirname "${BASH_SOURCE[0]}")/.." && pwd)"
+scratch="$(mktemp -d)"
+trap 'rm -rf "$scratch"' EXIT
+
+cat > "$scratch/hash_benchmark.cpp" <<'CPP'
+#include <Jakt/HashFunctions.h>
+#include <Jakt/StringHash.h>
+#include <algorithm>
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+static u32 jenkins_string_hash(char const* characters, size_t length)
+{
+    u32 hash = 0;
+    for (size_t i = 0; i < length; ++i) {
+        hash += (u32)characters[i];
+        hash += (hash << 10);
+        hash ^= (hash >> 6);
+    }
+    hash += hash << 3;
+    hash ^= hash >> 11;
+    hash += hash << 15;
+    return hash;
+}
+
+static unsigned shift_xor_int_hash(u32 key)
+{
+    key += ~(key << 15);
+    key ^= (key >> 10);
+    key += (key << 3);
+    key ^= (key >> 6);
+    key += ~(key << 11);
+    key ^= (key >> 16);
+    return key;
+}
+
+static unsigned shift_xor_u64_hash(u64 key)
+{
+    u32 first = shift_xor_int_hash(static_cast<u32>(key));
+    u32 last = shift_xor_int_hash(static_cast<u32>(key >> 32) * 413);
+    return shift_xor_int_hash((first * 209) ^ last);
+}
+
+template<typename Function>
+static void time(char const* name, char const* hash, int runs, size_t bytes, Function function)
+{
+    std::vector<long long> times;
+    unsigned sink = 0;
+    for (int run = 0; run < runs; ++run) {
+        auto start = std::chrono::steady_clock::now();
+        sink ^= function();
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        times.push_back(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+    }
+    std::sort(times.begin(), times.end());
+    double median = times[times.size() / 2] / 1000.0;
+    printf("%-22s %-10s median %8.2f ms, %7.2f GB/s (%08x)\n", name, hash, median, bytes / (median * 1e6), sink);
+}
+
+// Keys that hash into a slot some earlier key already took, in a table twice the number of keys.
+template<typename Key, typename Hash>
+static size_t collisions(std::vector<Key> const& keys, Hash hash)
+{
+    size_t slots = 1;
+    while (slots < keys.size() * 2)
+        slots <<= 1;
+    std::vector<bool> taken(slots);
+    size_t collisions = 0;
+    for (auto const& key : keys) {
+        auto slot = hash(key) & (slots - 1);
+        collisions += taken[slot];
+        taken[slot] = true;
+    }
+    return collisions;
+}
+
+// How far from half the time any output bit flips when a single input bit does, as a percentage.
+template<typename Hash>
+static double worst_avalanche_bias(int input_bits, Hash hash)
+{
+    double worst = 0;
+    int const samples = 20000;
+    for (int input_bit = 0; input_bit < input_bits; ++input_bit) {
+        int flips[32] = {};
+        unsigned long state = 987654321;
+        for (int i = 0; i < samples; ++i) {
+            state = state * 6364136223846793005ul + 1442695040888963407ul;
+            u64 key = state;
+            if (input_bits == 32)
+                key &= 0xffffffff;
+            unsigned difference = hash(key) ^ hash(key ^ (1ull << input_bit));
+            for (int output_bit = 0; output_bit < 32; ++output_bit)
+                flips[output_bit] += (difference >> output_bit) & 1;
+        }
+        for (int output_bit = 0; output_bit < 32; ++output_bit)
+            worst = std::max(worst, std::abs(flips[output_bit] * 100.0 / samples - 50.0));
+    }
+    return worst;
+}
+
+int main(int, char** argv)
+{
+    size_t size = strtoul(argv[1], nullptr, 10);
+    int runs = atoi(argv[2]);
+
+    // Identifier-like keys, the way the compiler's scopes and module tables see them.
+    std::vector<std::string> identifiers;
+    for (size_t i = 0; i < size; ++i)
+        identifiers.push_back("identifier_" + std::to_string(i));
+    auto jenkins = [](std::string const& key) { return jenkins_string_hash(key.data(), key.size()); };
+    auto wyhash = [](std::string const& key) { return Jakt::string_hash(key.data(), key.size()); };
+    printf("collisions, %zu identifiers: jenkins %zu, wyhash %zu\n", size, collisions(identifiers, jenkins), collisions(identifiers, wyhash));
+
+    std::vector<u64> sequential;
+    std::vector<u64> strided;
+    for (size_t i = 0; i < size; ++i) {
+        sequential.push_back(i);
+        strided.push_back(static_cast<u64>(i) << 32);
+    }
+    printf("collisions, %zu sequential u64s: shift/xor %zu, wyhash %zu\n", size, collisions(sequential, shift_xor_u64_hash), collisions(sequential, Jakt::u64_hash));
+    printf("collisions, %zu u64s i << 32: shift/xor %zu, wyhash %zu\n", size, collisions(strided, shift_xor_u64_hash), collisions(strided, Jakt::u64_hash));
+    printf("worst avalanche bias, u32: shift/xor %.1f%%, wyhash %.1f%%\n", worst_avalanche_bias(32, [](u64 key) { return shift_xor_int_hash(static_cast<u32>(key)); }), worst_avalanche_bias(32, [](u64 key) { return Jakt::int_hash(static_cast<u32>(key)); }));
+    printf("worst avalanche bias, u64: shift/xor %.1f%%, wyhash %.1f%%\n", worst_avalanche_bias(64, shift_xor_u64_hash), worst_avalanche_bias(64, Jakt::u64_hash));
+
+    for (size_t length : { 8, 16, 32, 100, 4096 }) {
+        std::string text(size * 16, 'x');
+        for (size_t i = 0; i < text.size(); ++i)
+            text[i] = static_cast<char>('a' + (i * 7 + i / 13) % 26);
+        size_t count = text.size() / length;
+        char name[32];
+        snprintf(name, sizeof(name), "strings of %zu bytes", length);
+        time(name, "jenkins", runs, count * length, [&] {
+            unsigned hash = 0;
+            for (size_t i = 0; i < count; ++i)
+                hash ^= jenkins_string_hash(text.data() + i * length, length);
+            return hash;
+        });
+        time(name, "wyhash", runs, count * length, [&] {
+            unsigned hash = 0;
+            for (size_t i = 0; i < count; ++i)
+                hash ^= Jakt::string_hash(text.data() + i * length, length);
+            return hash;
+        });
+    }
+
+    time("u64s", "shift/xor", runs, size * 8, [&] {
+        unsigned hash = 0;
+        for (size_t i = 0; i < size; ++i)
+            hash ^= shift_xor_u64_hash(i * 0x9e3779b97f4a7c15ull);
+        return hash;
+    });
+    time("u64s", "wyhash", runs, size * 8, [&] {
+        unsigned hash = 0;
+        for (size_t i = 0; i < size; ++i)
+            hash ^= Jakt::u64_hash(i * 0x9e3779b97f4a7c15ull);
+        return hash;
+    });
+    return 0;
+}
+CPP
+
+"$cxx" -std=c++20 -fno-exceptions -O2 -Wno-user-defined-literals -I "$repo_root/runtime" \
+    -o "$scratch/hash_benchmark" "$scratch/hash_benchmark.cpp"
+"$scratch/hash_benchmark" "$size" "$runs"
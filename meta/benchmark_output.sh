@@ -0,0 +1,51 @@
+#!/usr/bin/env bash
+
+# Times a program that prints one short formatted line per record, writing into a pipe (the case stdout is
+# block-buffered for), for each of the given compilers.
+#
+# Usage: meta/benchmark_output.sh [-n runs] [-l lines] compiler...
+# e.g.   meta/benchmark_output.sh -n 10 -l 2000000 build/bin/jakt_stage1 /usr/local/bin/jakt
+
+set -e
+
+runs=5
+lines=1000000
+while [ $# -gt 0 ]; do
+    case "$1" in
+        -n) runs="$2"; shift 2 ;;
+        -l) lines="$2"; shift 2 ;;
+        *) break ;;
+    esac
+done
+
+if [ $# -eq 0 ]; then
+    set -- build/bin/jakt_stage1
+fi
+
+repo_root="$(cd "$(dirname "${BASH_SOURCE[0]}")/.." && pwd)"
+scratch="$(mktemp -d)"
+trap 'rm -rf "$scratch"' EXIT
+
+cat > "$scratch/println_benchmark.jakt" <<JAKT
+function main() {
+    for i in 0..${lines} {
+        println("record {} of {}: value={:x}", i, ${lines}, i * 31)
+    }
+    eprintln("done")
+}
+JAKT
+
+cd "$repo_root"
+for compiler in "$@"; do
+    binary_dir="$scratch/build-$(basename "$compiler")"
+    "$compiler" -O -B "$binary_dir" -o println_benchmark "$scratch/println_benchmark.jakt"
+    times=()
+    for ((i = 0; i < runs; i++)); do
+        start=$(date +%s%N)
+        "$binary_dir/println_benchmark" 2>/dev/null | cat > /dev/null
+        end=$(date +%s%N)
+        times+=($(( (end - start) / 1000000 )))
+    done
+    sorted=($(printf '%s\n' "${times[@]}" | sort -n))
+    echo "$compiler: $lines lines, min ${sorted[0]} ms, median ${sorted[$((runs / 2))]} ms over $runs runs"
+done
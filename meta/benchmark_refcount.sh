@@ -0,0 +1,106 @@
+#!/usr/bin/env bash
+
+# Times threads copying and dropping references to RefCounted objects, with the runtime's refcounts built
+# non-atomic (the default) and atomic (JAKT_ATOMIC_REFCOUNT, `jakt --atomic-refcount`). Each thread either
+# churns a reference to an object of its own ("private", the uncontended cost of the counting mode), or all of
+# them churn references to one object ("shared", contended; atomic mode only, since non-atomic counts would race).
+#
+# Usage: meta/benchmark_refcount.sh [-n runs] [-c copies] [-t "thread counts"] [-C cxx-compiler] [library-dir]
+# e.g.   meta/benchmark_refcount.sh -n 5 -c 50000000 -t "1 2 4 8" build/lib
+
+set -e
+
+runs=5
+copies=20000000
+thread_counts="1 2 4 8"
+cxx=c++
+while [ $# -gt 0 ]; do
+    case "$1" in
+        -n) runs="$2"; shift 2 ;;
+        -c) copies="$2"; shift 2 ;;
+        -t) thread_counts="$2"; shift 2 ;;
+        -C) cxx="$2"; shift 2 ;;
+        *) break ;;
+    esac
+done
+
+repo_root="$(cd "$(dirname "${BASH_SOURCE[0]}")/.." && pwd)"
+library_dir="$(cd "${1:-$repo_root/build/lib}" && pwd)"
+scratch="$(mktemp -d)"
+trap 'rm -rf "$scratch"' EXIT
+
+cat > "$scratch/refcount_benchmark.cpp" <<'CPP'
+#include <Jakt/NonnullRefPtr.h>
+#include <Jakt/RefCounted.h>
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+class Node : public Jakt::RefCounted<Node> {
+public:
+    long value { 0 };
+};
+
+static void churn(Jakt::NonnullRefPtr<Node> const& node, long copies)
+{
+    for (long i = 0; i < copies; ++i) {
+        auto copy = node;
+        asm volatile("" : : "r"(copy.ptr()) : "memory");
+    }
+}
+
+int main(int, char** argv)
+{
+    int thread_count = atoi(argv[1]);
+    long copies = atol(argv[2]);
+    bool shared = strcmp(argv[3], "shared") == 0;
+
+    auto shared_node = Jakt::make_ref_counted<Node>();
+    std::vector<Jakt::NonnullRefPtr<Node>> nodes;
+    for (int i = 0; i < thread_count; ++i)
+        nodes.push_back(shared ? shared_node : Jakt::make_ref_counted<Node>());
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (int i = 0; i < thread_count; ++i)
+        threads.emplace_back([&, i] { churn(nodes[i], copies / thread_count); });
+    for (auto& thread : threads)
+        thread.join();
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    if (shared_node->ref_count() != (shared ? thread_count + 1 : 1))
+        return 1;
+    printf("%lld\n", (long long)std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count());
+    return 0;
+}
+CPP
+
+for mode in nonatomic atomic; do
+    flags=()
+    runtime_library="$library_dir/libjakt_runtime.a"
+    if [ "$mode" = atomic ]; then
+        flags+=(-DJAKT_ATOMIC_REFCOUNT)
+        runtime_library="$library_dir/libjakt_runtime_atomic.a"
+    fi
+    "$cxx" -std=c++20 -fno-exceptions -O2 -pthread -Wno-user-defined-literals "${flags[@]}" \
+        -I "$repo_root/runtime" -o "$scratch/refcount_$mode" "$scratch/refcount_benchmark.cpp" "$runtime_library"
+done
+
+for mode in nonatomic atomic; do
+    for sharing in private shared; do
+        if [ "$mode" = nonatomic ] && [ "$sharing" = shared ]; then
+            continue
+        fi
+        for threads in $thread_counts; do
+            times=()
+            for ((i = 0; i < runs; i++)); do
+                times+=($("$scratch/refcount_$mode" "$threads" "$copies" "$sharing"))
+            done
+            sorted=($(printf '%s\n' "${times[@]}" | sort -n))
+            echo "$mode, $sharing, $threads threads: $copies copies, min ${sorted[0]} ms, median ${sorted[$((runs / 2))]} ms over $runs runs"
+        done
+    done
+done
@@ -0,0 +1,74 @@
+#!/usr/bin/env bash
+
+# Times building a text of the given number of lines with `+=` on a String, with a StringBuilder and with a
+# jakt::rope Rope (joined with to_string() at the end), for each of the given compilers, to show the quadratic
+# cost of repeated String concatenation against the linear cost of the other two.
+#
+# Usage: meta/benchmark_rope.sh [-n runs] [-s lines] compiler...
+# e.g.   meta/benchmark_rope.sh -n 5 -s 10000 build/bin/jakt_stage1
+
+set -e
+
+runs=5
+lines=10000
+while [ $# -gt 0 ]; do
+    case "$1" in
+        -n) runs="$2"; shift 2 ;;
+        -s) lines="$2"; shift 2 ;;
+        *) break ;;
+    esac
+done
+
+if [ $# -eq 0 ]; then
+    set -- build/bin/jakt_stage1
+fi
+
+repo_root="$(cd "$(dirname "${BASH_SOURCE[0]}")/.." && pwd)"
+scratch="$(mktemp -d)"
+trap 'rm -rf "$scratch"' EXIT
+
+cat > "$scratch/rope_benchmark.jakt" <<JAKT
+import jakt::rope { Rope }
+
+function main(args: [String]) {
+    let mode = args[1]
+    mut length = 0uz
+    if mode == "string" {
+        mut text = ""
+        for i in 0..${lines} {
+            text += format("    let value_{} = compute({}, \"{}\")\n", i, i * 7, i)
+        }
+        length = text.length()
+    } else if mode == "builder" {
+        mut builder = StringBuilder::create()
+        for i in 0..${lines} {
+            builder.append_string(format("    let value_{} = compute({}, \"{}\")\n", i, i * 7, i))
+        }
+        length = builder.to_string().length()
+    } else {
+        mut rope = Rope::create()
+        for i in 0..${lines} {
+            rope.append(format("    let value_{} = compute({}, \"{}\")\n", i, i * 7, i))
+        }
+        length = rope.to_string().length()
+    }
+    println("{}", length)
+}
+JAKT
+
+cd "$repo_root"
+for compiler in "$@"; do
+    binary_dir="$scratch/build-$(basename "$compiler")"
+    "$compiler" -O -B "$binary_dir" -o rope_benchmark "$scratch/rope_benchmark.jakt" 2> /dev/null
+    for mode in string builder rope; do
+        times=()
+        for ((i = 0; i < runs; i++)); do
+            start=$(date +%s%N)
+            "$binary_dir/rope_benchmark" "$mode" > /dev/null
+            end=$(date +%s%N)
+            times+=($(( (end - start) / 1000000 )))
+        done
+        sorted=($(printf '%s\n' "${times[@]}" | sort -n))
+        echo "$compiler: $mode, $lines lines, min ${sorted[0]} ms, median ${sorted[$((runs / 2))]} ms over $runs runs"
+    done
+done
@@ -0,0 +1,37 @@
+#!/usr/bin/env bash
+
+# Times how long the given compilers take to lex, parse, typecheck and generate C++ for the selfhost
+# compiler (no C++ build). Each run starts from an empty binary dir so the module interface cache
+# never kicks in.
+#
+# Usage: meta/benchmark_selfhost.sh [-n runs] compiler...
+# e.g.   meta/benchmark_selfhost.sh -n 10 build/bin/jakt_stage1 build/bin/jakt_stage2
+
+set -e
+
+runs=5
+if [ "$1" == "-n" ]; then
+    runs="$2"
+    shift 2
+fi
+
+if [ $# -eq 0 ]; then
+    set -- build/bin/jakt_stage1
+fi
+
+repo_root="$(cd "$(dirname "${BASH_SOURCE[0]}")/.." && pwd)"
+scratch="$(mktemp -d)"
+trap 'rm -rf "$scratch"' EXIT
+
+for compiler in "$@"; do
+    times=()
+    for ((i = 0; i < runs; i++)); do
+        rm -rf "$scratch/out"
+        start=$(date +%s%N)
+        "$compiler" -S --binary-dir "$scratch/out" "$repo_root/selfhost/main.jakt" > /dev/null
+        end=$(date +%s%N)
+        times+=($(( (end - start) / 1000000 )))
+    done
+    sorted=($(printf '%s\n' "${times[@]}" | sort -n))
+    echo "$compiler: min ${sorted[0]} ms, median ${sorted[$((runs / 2))]} ms over $runs runs"
+done
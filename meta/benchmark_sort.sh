@@ -0,0 +1,109 @@
+#!/usr/bin/env bash
+
+# Times Jakt::sort (radix sort for integers, introsort otherwise), the same introsort through a comparator, and
+# Jakt::stable_sort against std::sort and std::stable_sort, on i64s and Jakt::Strings in a few orders, and checks
+# that every result matches std::sort's.
+#
+# Usage: meta/benchmark_sort.sh [-n runs] [-s size] [-C cxx-compiler] [library-dir]
+# e.g.   meta/benchmark_sort.sh -n 5 -s 1000000 build/lib
+
+set -e
+
+runs=5
+size=1000000
+cxx=c++
+while [ $# -gt 0 ]; do
+    case "$1" in
+        -n) runs="$2"; shift 2 ;;
+        -s) size="$2"; shift 2 ;;
+        -C) cxx="$2"; shift 2 ;;
+        *) break ;;
+    esac
+done
+
+repo_root="$(cd "$(dirname "${BASH_SOURCE[0]}")/.." && pwd)"
+library_dir="$(cd "${1:-$repo_root/build/lib}" && pwd)"
+scratch="$(mktemp -d)"
+trap 'rm -rf "$scratch"' EXIT
+
+cat > "$scratch/sort_benchmark.cpp" <<'CPP'
+#include <Jakt/Sort.h>
+#include <Jakt/String.h>
+#include <algorithm>
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+template<typename T>
+static std::vector<T> make_input(char const* order, size_t size, T (*make)(long))
+{
+    std::vector<T> values;
+    unsigned long state = 12345;
+    for (size_t i = 0; i < size; ++i) {
+        state = state * 6364136223846793005ul + 1442695040888963407ul;
+        long random = static_cast<long>(state >> 17);
+        long value = random;
+        if (strcmp(order, "sorted") == 0)
+            value = static_cast<long>(i);
+        else if (strcmp(order, "reversed") == 0)
+            value = static_cast<long>(size - i);
+        else if (strcmp(order, "few-unique") == 0)
+            value = random % 16;
+        values.push_back(make(value));
+    }
+    return values;
+}
+
+template<typename T, typename Sort>
+static void run(char const* type, char const* order, char const* algorithm, std::vector<T> const& input, std::vector<T> const& expected, int runs, Sort sort)
+{
+    std::vector<long long> times;
+    for (int run = 0; run < runs; ++run) {
+        auto values = input;
+        auto start = std::chrono::steady_clock::now();
+        sort(values);
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        times.push_back(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+        for (size_t i = 0; i < values.size(); ++i) {
+            if (values[i] < expected[i] || expected[i] < values[i]) {
+                printf("%s, %s, %s: wrong result at %zu\n", type, order, algorithm, i);
+                exit(1);
+            }
+        }
+    }
+    std::sort(times.begin(), times.end());
+    printf("%-7s %-11s %-18s min %8.2f ms, median %8.2f ms\n", type, order, algorithm, times[0] / 1000.0, times[times.size() / 2] / 1000.0);
+}
+
+template<typename T>
+static void run_all(char const* type, size_t size, int runs, T (*make)(long))
+{
+    auto less = [](T const& a, T const& b) { return a < b; };
+    for (auto const* order : { "random", "sorted", "reversed", "few-unique" }) {
+        auto input = make_input<T>(order, size, make);
+        auto expected = input;
+        std::sort(expected.begin(), expected.end());
+
+        run(type, order, "std::sort", input, expected, runs, [&](auto& values) { std::sort(values.begin(), values.end()); });
+        run(type, order, "Jakt::sort", input, expected, runs, [&](auto& values) { Jakt::sort(values.data(), values.size()); });
+        run(type, order, "Jakt::sort (less)", input, expected, runs, [&](auto& values) { Jakt::sort(values.data(), values.size(), less); });
+        run(type, order, "std::stable_sort", input, expected, runs, [&](auto& values) { std::stable_sort(values.begin(), values.end()); });
+        run(type, order, "Jakt::stable_sort", input, expected, runs, [&](auto& values) { (void)Jakt::stable_sort(values.data(), values.size()); });
+    }
+}
+
+int main(int, char** argv)
+{
+    size_t size = strtoul(argv[1], nullptr, 10);
+    int runs = atoi(argv[2]);
+    run_all<long>("i64", size, runs, [](long value) { return value; });
+    run_all<Jakt::String>("String", size / 4, runs, [](long value) { return MUST(Jakt::String::formatted("{}", value % 1000000)); });
+    return 0;
+}
+CPP
+
+"$cxx" -std=c++20 -fno-exceptions -O2 -Wno-user-defined-literals -I "$repo_root/runtime" \
+    -o "$scratch/sort_benchmark" "$scratch/sort_benchmark.cpp" "$library_dir/libjakt_runtime.a"
+"$scratch/sort_benchmark" "$size" "$runs"
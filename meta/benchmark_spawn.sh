@@ -0,0 +1,102 @@
+#!/usr/bin/env bash
+
+# Times starting and reaping `true` with fork() + execvp(), the way the compiler and jakttest used to start their
+# jobs, against spawn_process() from the runtime, from a parent that has touched a given amount of memory. fork()
+# copies the parent's page tables, so it slows down as the parent grows; posix_spawnp() doesn't.
+#
+# Usage: meta/benchmark_spawn.sh [-n runs] [-c children] [-m "parent sizes in MiB"] [-C cxx-compiler] [library-dir]
+# e.g.   meta/benchmark_spawn.sh -n 5 -c 500 -m "16 256 1024" build/lib
+
+set -e
+
+runs=5
+children=500
+sizes="16 256 1024"
+cxx=c++
+while [ $# -gt 0 ]; do
+    case "$1" in
+        -n) runs="$2"; shift 2 ;;
+        -c) children="$2"; shift 2 ;;
+        -m) sizes="$2"; shift 2 ;;
+        -C) cxx="$2"; shift 2 ;;
+        *) break ;;
+    esac
+done
+
+repo_root="$(cd "$(dirname "${BASH_SOURCE[0]}")/.." && pwd)"
+library_dir="$(cd "${1:-$repo_root/build/lib}" && pwd)"
+scratch="$(mktemp -d)"
+trap 'rm -rf "$scratch"' EXIT
+
+cat > "$scratch/spawn_benchmark.cpp" <<'CPP'
+#include <Process/Process.h>
+#include <algorithm>
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace Jakt;
+
+static void fork_exec_true()
+{
+    char* argv[] = { const_cast<char*>("true"), nullptr };
+    pid_t pid = fork();
+    if (pid == 0) {
+        execvp(argv[0], argv);
+        _exit(127);
+    }
+    int status = 0;
+    waitpid(pid, &status, 0);
+}
+
+static void spawn_true(Array<String> const& args)
+{
+    auto pid = MUST(spawn_process(args, {}, {}, {}));
+    (void)MUST(wait_for_exit(pid));
+}
+
+template<typename Callback>
+static double median_ms(int runs, int children, Callback callback)
+{
+    std::vector<double> times;
+    for (int run = 0; run < runs; ++run) {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < children; ++i)
+            callback();
+        auto end = std::chrono::steady_clock::now();
+        times.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+    }
+    std::sort(times.begin(), times.end());
+    return times[times.size() / 2];
+}
+
+int main(int argc, char** argv)
+{
+    size_t megabytes = strtoul(argv[1], nullptr, 10);
+    int runs = atoi(argv[2]);
+    int children = atoi(argv[3]);
+
+    size_t size = megabytes << 20;
+    auto* ballast = static_cast<char*>(malloc(size));
+    memset(ballast, 1, size);
+
+    auto args = MUST(Array<String>::create_with({ String("true") }));
+    double forked = median_ms(runs, children, fork_exec_true);
+    double spawned = median_ms(runs, children, [&] { spawn_true(args); });
+    printf("%5zu MiB parent, %d children: fork+execvp %8.1f ms, spawn_process %8.1f ms (median of %d runs)\n",
+        megabytes, children, forked, spawned, runs);
+
+    free(ballast);
+    return 0;
+}
+CPP
+
+"$cxx" -std=c++20 -fno-exceptions -O2 -Wno-user-defined-literals -I "$repo_root/runtime" \
+    -o "$scratch/spawn_benchmark" "$scratch/spawn_benchmark.cpp" "$library_dir/libjakt_runtime.a"
+for megabytes in $sizes; do
+    "$scratch/spawn_benchmark" "$megabytes" "$runs" "$children"
+done
@@ -0,0 +1,123 @@
+#!/usr/bin/env bash
+
+# Times the vectorized substring search behind String::contains() and friends against the scalar search it
+# replaced and std::string_view::find, for a few needle lengths, and String::split() and String::replace() on a
+# long line, checking every result against std::string_view.
+#
+# Usage: meta/benchmark_strings.sh [-n runs] [-s size] [-C cxx-compiler] [library-dir]
+# e.g.   meta/benchmark_strings.sh -n 5 -s 16000000 build/lib
+
+set -e
+
+runs=5
+size=16000000
+cxx=c++
+while [ $# -gt 0 ]; do
+    case "$1" in
+        -n) runs="$2"; shift 2 ;;
+        -s) size="$2"; shift 2 ;;
+        -C) cxx="$2"; shift 2 ;;
+        *) break ;;
+    esac
+done
+
+repo_root="$(cd "$(dirname "${BASH_SOURCE[0]}")/.." && pwd)"
+library_dir="$(cd "${1:-$repo_root/build/lib}" && pwd)"
+scratch="$(mktemp -d)"
+trap 'rm -rf "$scratch"' EXIT
+
+cat > "$scratch/strings_benchmark.cpp" <<'CPP'
+#include <Jakt/MemMem.h>
+#include <Jakt/String.h>
+#include <algorithm>
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <string_view>
+#include <vector>
+
+template<typename Function>
+static void run(char const* name, char const* algorithm, int runs, size_t expected, Function function)
+{
+    std::vector<long long> times;
+    for (int run = 0; run < runs; ++run) {
+        auto start = std::chrono::steady_clock::now();
+        size_t result = function();
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        times.push_back(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+        if (result != expected) {
+            printf("%s, %s: got %zu, expected %zu\n", name, algorithm, result, expected);
+            exit(1);
+        }
+    }
+    std::sort(times.begin(), times.end());
+    printf("%-18s %-18s min %8.2f ms, median %8.2f ms\n", name, algorithm, times[0] / 1000.0, times[times.size() / 2] / 1000.0);
+}
+
+int main(int, char** argv)
+{
+    size_t size = strtoul(argv[1], nullptr, 10);
+    int runs = atoi(argv[2]);
+
+    // Words of lowercase letters separated by spaces, which gives the first and last bytes of a needle plenty of
+    // chances to match on their own.
+    std::string text;
+    unsigned long state = 12345;
+    while (text.size() < size) {
+        state = state * 6364136223846793005ul + 1442695040888963407ul;
+        text.push_back((state >> 33) % 7 == 0 ? ' ' : static_cast<char>('a' + (state >> 40) % 8));
+    }
+    std::string_view haystack = text;
+
+    for (size_t needle_length : { 1, 2, 4, 8, 16, 31, 48 }) {
+        // A needle that doesn't occur, but whose first and last bytes do, so every search scans the whole text.
+        std::string needle(needle_length, 'z');
+        if (needle_length > 1)
+            needle.front() = needle.back() = 'a';
+        char name[32];
+        snprintf(name, sizeof(name), "find %zu bytes", needle_length);
+        auto expected = haystack.find(needle);
+        if (expected == std::string_view::npos)
+            expected = haystack.size();
+        auto position_or_size = [&](Jakt::Optional<size_t> position) { return position.value_or(haystack.size()); };
+
+        run(name, "std::string_view", runs, expected, [&] {
+            auto position = haystack.find(needle);
+            return position == std::string_view::npos ? haystack.size() : position;
+        });
+        run(name, "scalar", runs, expected, [&] {
+            return position_or_size(Jakt::Detail::memmem_scalar(haystack.data(), haystack.size(), needle.data(), needle.size()));
+        });
+        run(name, "memmem_optional", runs, expected, [&] {
+            return position_or_size(Jakt::memmem_optional(haystack.data(), haystack.size(), needle.data(), needle.size()));
+        });
+    }
+
+    auto string = MUST(Jakt::String::copy(Jakt::StringView { text.data(), text.size() }));
+    size_t words = 0;
+    for (size_t start = 0; start < haystack.size();) {
+        auto end = std::min(haystack.find(' ', start), haystack.size());
+        words += end != start;
+        start = end + 1;
+    }
+    run("split", "String::split", runs, words, [&] { return MUST(string.split(' ')).size(); });
+
+    size_t replaced_length = 0;
+    for (size_t start = 0;;) {
+        auto position = haystack.find("ab", start);
+        if (position == std::string_view::npos) {
+            replaced_length += haystack.size() - start;
+            break;
+        }
+        replaced_length += position - start + 3;
+        start = position + 2;
+    }
+    run("replace", "String::replace", runs, replaced_length, [&] { return MUST(string.replace(Jakt::StringView { "ab", 2 }, Jakt::StringView { "xyz", 3 })).length(); });
+    return 0;
+}
+CPP
+
+"$cxx" -std=c++20 -fno-exceptions -O2 -Wno-user-defined-literals -I "$repo_root/runtime" \
+    -o "$scratch/strings_benchmark" "$scratch/strings_benchmark.cpp" "$library_dir/libjakt_runtime.a"
+"$scratch/strings_benchmark" "$size" "$runs"
@@ -0,0 +1,71 @@
+#!/usr/bin/env bash
+
+# Times a CPU-bound parallel_for from jakt::threads at each of the given thread counts, for each of the given
+# compilers, to show how the work-stealing pool scales.
+#
+# Usage: meta/benchmark_threads.sh [-n runs] [-s size] [-t "thread counts"] compiler...
+# e.g.   meta/benchmark_threads.sh -n 5 -s 200000 -t "1 2 4 8 16" build/bin/jakt_stage1
+
+set -e
+
+runs=5
+size=100000
+thread_counts="1 2 4 8 16"
+while [ $# -gt 0 ]; do
+    case "$1" in
+        -n) runs="$2"; shift 2 ;;
+        -s) size="$2"; shift 2 ;;
+        -t) thread_counts="$2"; shift 2 ;;
+        *) break ;;
+    esac
+done
+
+if [ $# -eq 0 ]; then
+    set -- build/bin/jakt_stage1
+fi
+
+repo_root="$(cd "$(dirname "${BASH_SOURCE[0]}")/.." && pwd)"
+scratch="$(mktemp -d)"
+trap 'rm -rf "$scratch"' EXIT
+
+cat > "$scratch/threads_benchmark.jakt" <<JAKT
+import jakt::threads { parallel_for, set_thread_count }
+
+function churn(anon seed: u64) -> u64 {
+    mut state = seed
+    for _ in 0..2000 {
+        state = unchecked_add(unchecked_mul(state, 6364136223846793005u64), 1442695040888963407u64)
+    }
+    return state
+}
+
+function main(args: [String]) {
+    set_thread_count(args[1].to_uint()! as! usize)
+    mut results: [u64] = [0u64; ${size}]
+    parallel_for(0uz..${size}uz, chunk: 0, body: &function[&mut results](index: usize) throws {
+        results[index] = churn(index as! u64)
+    })
+    mut checksum = 0u64
+    for result in results.iterator() {
+        checksum ^= result
+    }
+    println("{}", checksum)
+}
+JAKT
+
+cd "$repo_root"
+for compiler in "$@"; do
+    binary_dir="$scratch/build-$(basename "$compiler")"
+    "$compiler" -O -B "$binary_dir" -o threads_benchmark "$scratch/threads_benchmark.jakt"
+    for threads in $thread_counts; do
+        times=()
+        for ((i = 0; i < runs; i++)); do
+            start=$(date +%s%N)
+            "$binary_dir/threads_benchmark" "$threads" > /dev/null
+            end=$(date +%s%N)
+            times+=($(( (end - start) / 1000000 )))
+        done
+        sorted=($(printf '%s\n' "${times[@]}" | sort -n))
+        echo "$compiler: $threads threads, $size items, min ${sorted[0]} ms, median ${sorted[$((runs / 2))]} ms over $runs runs"
+    done
+done
@@ -0,0 +1,92 @@
+#!/usr/bin/env bash
+
+# Builds small programs twice into the same binary dir, changing only the main file or the options in between,
+# so the second build may reuse the imported modules' generated code (see
+# Typechecker::load_module_interface_record), and checks that it only does so when it should.
+#
+# Usage: meta/test_interface_cache.sh [compiler]
+# e.g.   meta/test_interface_cache.sh build/bin/jakt
+
+set -e
+
+repo_root="$(cd "$(dirname "${BASH_SOURCE[0]}")/.." && pwd)"
+jakt="${1:-$repo_root/build/bin/jakt}"
+jakt="$(cd "$(dirname "$jakt")" && pwd)/$(basename "$jakt")"
+scratch="$(mktemp -d)"
+trap 'rm -rf "$scratch"' EXIT
+
+failures=0
+
+# check <name> <expected output>: builds $scratch/<name>/main.jakt, edits it, rebuilds and runs it.
+check() {
+    local name="$1" expected="$2"
+    local dir="$scratch/$name"
+    (cd "$dir" && "$jakt" -B out main.jakt > build.log 2>&1) || { echo "FAIL $name: first build"; cat "$dir/build.log"; failures=$((failures + 1)); return; }
+    sed -i.orig 's/"first"/"second"/' "$dir/main.jakt"
+    (cd "$dir" && "$jakt" -B out main.jakt > build.log 2>&1) || { echo "FAIL $name: second build"; cat "$dir/build.log"; failures=$((failures + 1)); return; }
+    if ! ls "$dir"/out/*.jakt-interface > /dev/null 2>&1; then
+        echo "FAIL $name: no interface records written"
+        failures=$((failures + 1))
+        return
+    fi
+    local output
+    output="$("$dir/out/main" 2>&1)" || { echo "FAIL $name: exited with $?: $output"; failures=$((failures + 1)); return; }
+    if [ "$output" != "$expected" ]; then
+        echo "FAIL $name: expected '$expected', got '$output'"
+        failures=$((failures + 1))
+        return
+    fi
+    echo "PASS $name"
+}
+
+# A callee whose body is deferred must not be assumed to leave its arguments alone: here it stores one.
+mkdir -p "$scratch/escaping_argument"
+cat > "$scratch/escaping_argument/store.jakt" <<'JAKT'
+class Node {
+    public name: String
+}
+
+function remember(mut registry: [Node], node: Node) throws {
+    registry.push(node)
+}
+JAKT
+cat > "$scratch/escaping_argument/main.jakt" <<'JAKT'
+import store { Node, remember }
+
+function main() {
+    mut registry: [Node] = []
+    let node = Node(name: "first")
+    remember(registry, node)
+    println("{}", registry[0].name)
+}
+JAKT
+check escaping_argument "second"
+
+# An option that changes the generated C++ must change the interface keys too: adding -d has to regenerate the
+# imported module's implementation with #line directives in it.
+mkdir -p "$scratch/changed_options"
+cat > "$scratch/changed_options/greeting.jakt" <<'JAKT'
+function greeting() throws -> String {
+    return "hello"
+}
+JAKT
+cat > "$scratch/changed_options/main.jakt" <<'JAKT'
+import greeting { greeting }
+
+function main() {
+    println("{}", greeting())
+}
+JAKT
+dir="$scratch/changed_options"
+if ! (cd "$dir" && "$jakt" -B out main.jakt > build.log 2>&1 && "$jakt" -d -B out main.jakt > build.log 2>&1); then
+    echo "FAIL changed_options: build"
+    cat "$dir/build.log"
+    failures=$((failures + 1))
+elif ! grep -q "^#line" "$dir/out/greeting.cpp"; then
+    echo "FAIL changed_options: greeting.cpp was reused from the build without -d"
+    failures=$((failures + 1))
+else
+    echo "PASS changed_options"
+fi
+
+[ "$failures" -eq 0 ]
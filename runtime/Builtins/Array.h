@@ -4,6 +4,8 @@
 #include <Jakt/Error.h>
 #include <Jakt/RefCounted.h>
 #include <Jakt/RefPtr.h>
+#include <Jakt/Sort.h>
+#include <Jakt/kmalloc.h>
 #include <Builtins/Range.h>
 #include <initializer_list>
 #include <stdlib.h>
@@ -15,14 +17,15 @@ template<typename T>
 class ArraySlice;
 
 template<typename T>
-class ArrayStorage : public RefCounted<ArrayStorage<T>> {
+class ArrayStorage : public RefCounted<ArrayStorage<T>>
+    , public SlabAllocated {
 public:
     ArrayStorage() { }
 
     ~ArrayStorage()
     {
         shrink(0);
-        free(m_elements);
+        kfree_slab(m_elements, m_capacity * sizeof(T));
     }
 
     bool is_empty() const { return m_size == 0; }
@@ -37,7 +40,7 @@ public:
         if (Checked<size_t>::multiplication_would_overflow(capacity, sizeof(T))) {
             return Error::from_errno(EOVERFLOW);
         }
-        auto* new_elements = static_cast<T*>(malloc(capacity * sizeof(T)));
+        auto* new_elements = static_cast<T*>(kmalloc_slab(capacity * sizeof(T)));
         if (!new_elements) {
             return Error::from_errno(ENOMEM);
         }
@@ -45,7 +48,7 @@ public:
             new (&new_elements[i]) T(move(m_elements[i]));
             m_elements[i].~T();
         }
-        free(m_elements);
+        kfree_slab(m_elements, m_capacity * sizeof(T));
         m_elements = new_elements;
         m_capacity = capacity;
         return {};
@@ -127,6 +130,10 @@ public:
         return m_elements[index];
     }
 
+    // For indices the compiler has proven to be in bounds.
+    T const& unchecked_at(size_t index) const { return m_elements[index]; }
+    T& unchecked_at(size_t index) { return m_elements[index]; }
+
     ErrorOr<void> push(T value)
     {
         TRY(add_capacity(1));
@@ -156,6 +163,7 @@ public:
     }
 
     T* unsafe_data() { return m_elements; }
+    T const* unsafe_data() const { return m_elements; }
 
 private:
     size_t m_size { 0 };
@@ -250,11 +258,31 @@ public:
         return m_storage->at(index);
     }
 
+    T const& unchecked_at(size_t index) const { return m_storage->unchecked_at(index); }
+    T& unchecked_at(size_t index) { return m_storage->unchecked_at(index); }
+
     bool contains(T const& value) const
     {
         return m_storage->contains(value);
     }
 
+    // See Jakt/Sort.h. The searches expect the array to be sorted by `<`.
+    void sort() { Jakt::sort(m_storage->unsafe_data(), size()); }
+    template<typename Less>
+    void sort_by(Less const& less) { Jakt::sort(m_storage->unsafe_data(), size(), less); }
+    ErrorOr<void> stable_sort() { return Jakt::stable_sort(m_storage->unsafe_data(), size()); }
+    template<typename Less>
+    ErrorOr<void> stable_sort_by(Less const& less) { return Jakt::stable_sort(m_storage->unsafe_data(), size(), less); }
+
+    size_t lower_bound(T const& value) const { return Jakt::lower_bound(m_storage->unsafe_data(), size(), value); }
+    Optional<size_t> binary_search(T const& value) const
+    {
+        auto index = lower_bound(value);
+        if (index == size() || value < at(index))
+            return {};
+        return index;
+    }
+
     T const& operator[](size_t index) const { return at(index); }
     T& operator[](size_t index) { return at(index); }
 
@@ -343,6 +371,9 @@ public:
         return at(size() - 1);
     }
 
+    static void make_optional_niche(Array* storage) { NonnullRefPtr<Storage>::make_optional_niche(&storage->m_storage); }
+    static bool is_optional_niche(Array const* storage) { return NonnullRefPtr<Storage>::is_optional_niche(&storage->m_storage); }
+
 private:
     explicit Array(NonnullRefPtr<Storage> storage)
         : m_storage(storage)
@@ -429,6 +460,46 @@ public:
         return false;
     }
 
+    // Sort and search the slice's part of the array in place, like the Array methods of the same names.
+    void sort()
+    {
+        if (!is_empty())
+            Jakt::sort(m_storage->unsafe_data() + m_offset, size());
+    }
+    template<typename Less>
+    void sort_by(Less const& less)
+    {
+        if (!is_empty())
+            Jakt::sort(m_storage->unsafe_data() + m_offset, size(), less);
+    }
+    ErrorOr<void> stable_sort()
+    {
+        if (is_empty())
+            return {};
+        return Jakt::stable_sort(m_storage->unsafe_data() + m_offset, size());
+    }
+    template<typename Less>
+    ErrorOr<void> stable_sort_by(Less const& less)
+    {
+        if (is_empty())
+            return {};
+        return Jakt::stable_sort(m_storage->unsafe_data() + m_offset, size(), less);
+    }
+
+    size_t lower_bound(T const& value) const
+    {
+        if (is_empty())
+            return 0;
+        return Jakt::lower_bound(static_cast<T const*>(m_storage->unsafe_data()) + m_offset, size(), value);
+    }
+    Optional<size_t> binary_search(T const& value) const
+    {
+        auto index = lower_bound(value);
+        if (index == size() || value < at(index))
+            return {};
+        return index;
+    }
+
     Optional<T> first() const
     {
         if (is_empty())
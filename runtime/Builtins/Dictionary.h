@@ -15,7 +15,8 @@ namespace JaktInternal {
 using namespace Jakt;
 
 template<typename K, typename V>
-struct DictionaryStorage : public RefCounted<DictionaryStorage<K, V>> {
+struct DictionaryStorage : public RefCounted<DictionaryStorage<K, V>>
+    , public SlabAllocated {
     HashMap<K, V> map;
 };
 
@@ -110,6 +111,9 @@ public:
 
     DictionaryIterator<K, V> iterator() const { return DictionaryIterator<K, V> { m_storage }; }
 
+    static void make_optional_niche(Dictionary* storage) { NonnullRefPtr<Storage>::make_optional_niche(&storage->m_storage); }
+    static bool is_optional_niche(Dictionary const* storage) { return NonnullRefPtr<Storage>::is_optional_niche(&storage->m_storage); }
+
 private:
     explicit Dictionary(NonnullRefPtr<Storage> storage)
         : m_storage(move(storage))
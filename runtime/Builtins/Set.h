@@ -13,7 +13,8 @@ namespace JaktInternal {
 using namespace Jakt;
 
 template<typename T>
-struct SetStorage : public RefCounted<SetStorage<T>> {
+struct SetStorage : public RefCounted<SetStorage<T>>
+    , public SlabAllocated {
     HashTable<T> table;
 };
 
@@ -0,0 +1,718 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <IO/EventLoop.h>
+#include <Jakt/ScopeGuard.h>
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <signal.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace JaktInternal {
+
+// How many events one epoll_wait() may return, and how much a stream reads per readiness.
+static constexpr int max_events_per_wait = 256;
+static constexpr size_t read_chunk_size = 64 * 1024;
+
+static u64 monotonic_milliseconds()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return static_cast<u64>(now.tv_sec) * 1000 + static_cast<u64>(now.tv_nsec) / 1000000;
+}
+
+bool EventLoop::fires_before(Timer const& a, Timer const& b)
+{
+    if (a.m_deadline != b.m_deadline)
+        return a.m_deadline < b.m_deadline;
+    return a.m_sequence < b.m_sequence;
+}
+
+void Timer::cancel() const
+{
+    if (!m_active)
+        return;
+    m_active = false;
+    // Drop the callback now rather than when the timer reaches the top of the heap, in case it holds on to
+    // something that holds on to this timer.
+    m_callback = nullptr;
+    if (auto* loop = exchange(m_loop, nullptr))
+        loop->timer_deactivated();
+}
+
+ErrorOr<NonnullRefPtr<EventLoop>> EventLoop::create()
+{
+    // Writing to a pipe whose reader has gone away would otherwise kill the process with SIGPIPE; with the signal
+    // ignored, the write fails with EPIPE and the error is returned to whoever wrote. Sockets are written with
+    // MSG_NOSIGNAL instead, but pipes have nothing like it. A handler someone else installed is left alone.
+    struct sigaction pipe_action { };
+    if (sigaction(SIGPIPE, nullptr, &pipe_action) == 0 && pipe_action.sa_handler == SIG_DFL)
+        signal(SIGPIPE, SIG_IGN);
+
+    int epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd == -1)
+        return Error::from_errno(errno);
+    ScopeGuard close_on_error = [&] {
+        if (epoll_fd != -1)
+            ::close(epoll_fd);
+    };
+    auto watchers = TRY(Array<Watcher>::create_empty());
+    auto timers = TRY(Array<NonnullRefPtr<Timer>>::create_empty());
+    auto loop = TRY(adopt_nonnull_ref_or_enomem(new (nothrow) EventLoop(epoll_fd, move(watchers), move(timers))));
+    epoll_fd = -1;
+    return loop;
+}
+
+EventLoop::~EventLoop()
+{
+    for (size_t i = 0; i < m_timers.size(); ++i)
+        m_timers[i]->m_loop = nullptr;
+    ::close(m_epoll_fd);
+}
+
+ErrorOr<void> EventLoop::update_interest(i32 fd, Watcher const& old_watcher) const
+{
+    auto const& watcher = m_watchers[fd];
+    bool was_watched = old_watcher.on_readable || old_watcher.on_writable;
+    bool is_watched = watcher.on_readable || watcher.on_writable;
+
+    struct epoll_event event { };
+    event.data.fd = fd;
+    if (watcher.on_readable)
+        event.events |= EPOLLIN | EPOLLRDHUP;
+    if (watcher.on_writable)
+        event.events |= EPOLLOUT;
+
+    int operation = EPOLL_CTL_MOD;
+    if (!was_watched && is_watched)
+        operation = EPOLL_CTL_ADD;
+    else if (was_watched && !is_watched)
+        operation = EPOLL_CTL_DEL;
+    else if (!was_watched && !is_watched)
+        return {};
+
+    if (epoll_ctl(m_epoll_fd, operation, fd, &event) == -1) {
+        // Leave things as they were, so the watcher list keeps matching what epoll knows about.
+        int error = errno;
+        m_watchers[fd] = old_watcher;
+        return Error::from_errno(error);
+    }
+    if (operation == EPOLL_CTL_ADD)
+        ++m_watched_count;
+    else if (operation == EPOLL_CTL_DEL)
+        --m_watched_count;
+    return {};
+}
+
+ErrorOr<void> EventLoop::watch_readable(i32 fd, Function<ErrorOr<void>()> callback) const
+{
+    if (fd < 0)
+        return Error::from_errno(EBADF);
+    if (static_cast<size_t>(fd) >= m_watchers.size())
+        TRY(m_watchers.resize(fd + 1));
+    auto callback_holder = TRY(adopt_nonnull_ref_or_enomem(new (nothrow) SharedCallback<ErrorOr<void>()>(move(callback))));
+    auto old_watcher = m_watchers[fd];
+    m_watchers[fd].on_readable = move(callback_holder);
+    return update_interest(fd, old_watcher);
+}
+
+ErrorOr<void> EventLoop::watch_writable(i32 fd, Function<ErrorOr<void>()> callback) const
+{
+    if (fd < 0)
+        return Error::from_errno(EBADF);
+    if (static_cast<size_t>(fd) >= m_watchers.size())
+        TRY(m_watchers.resize(fd + 1));
+    auto callback_holder = TRY(adopt_nonnull_ref_or_enomem(new (nothrow) SharedCallback<ErrorOr<void>()>(move(callback))));
+    auto old_watcher = m_watchers[fd];
+    m_watchers[fd].on_writable = move(callback_holder);
+    return update_interest(fd, old_watcher);
+}
+
+ErrorOr<void> EventLoop::unwatch_readable(i32 fd) const
+{
+    if (fd < 0 || static_cast<size_t>(fd) >= m_watchers.size())
+        return {};
+    auto old_watcher = m_watchers[fd];
+    m_watchers[fd].on_readable = nullptr;
+    return update_interest(fd, old_watcher);
+}
+
+ErrorOr<void> EventLoop::unwatch_writable(i32 fd) const
+{
+    if (fd < 0 || static_cast<size_t>(fd) >= m_watchers.size())
+        return {};
+    auto old_watcher = m_watchers[fd];
+    m_watchers[fd].on_writable = nullptr;
+    return update_interest(fd, old_watcher);
+}
+
+ErrorOr<void> EventLoop::unwatch(i32 fd) const
+{
+    if (fd < 0 || static_cast<size_t>(fd) >= m_watchers.size())
+        return {};
+    auto old_watcher = m_watchers[fd];
+    m_watchers[fd] = {};
+    return update_interest(fd, old_watcher);
+}
+
+ErrorOr<void> EventLoop::push_timer(NonnullRefPtr<Timer> timer) const
+{
+    TRY(m_timers.push(move(timer)));
+    size_t index = m_timers.size() - 1;
+    while (index > 0) {
+        size_t parent = (index - 1) / 2;
+        if (!fires_before(*m_timers[index], *m_timers[parent]))
+            break;
+        swap(m_timers[index], m_timers[parent]);
+        index = parent;
+    }
+    return {};
+}
+
+NonnullRefPtr<Timer> EventLoop::pop_timer() const
+{
+    swap(m_timers[0], m_timers[m_timers.size() - 1]);
+    auto timer = m_timers.pop().release_value();
+    size_t count = m_timers.size();
+    size_t index = 0;
+    while (true) {
+        size_t earliest = index;
+        for (size_t child = 2 * index + 1; child <= 2 * index + 2 && child < count; ++child) {
+            if (fires_before(*m_timers[child], *m_timers[earliest]))
+                earliest = child;
+        }
+        if (earliest == index)
+            break;
+        swap(m_timers[index], m_timers[earliest]);
+        index = earliest;
+    }
+    return timer;
+}
+
+void EventLoop::timer_deactivated() const
+{
+    --m_active_timer_count;
+}
+
+ErrorOr<NonnullRefPtr<Timer>> EventLoop::add_timer(u64 milliseconds, bool repeat, Function<ErrorOr<void>()> callback) const
+{
+    u64 interval = repeat ? max<u64>(milliseconds, 1) : 0;
+    auto timer = TRY(adopt_nonnull_ref_or_enomem(new (nothrow) Timer(*this, monotonic_milliseconds() + milliseconds, interval, m_next_timer_sequence++, move(callback))));
+    TRY(push_timer(timer));
+    ++m_active_timer_count;
+    return timer;
+}
+
+ErrorOr<void> EventLoop::fire_expired_timers() const
+{
+    u64 now = monotonic_milliseconds();
+    // Timers that a callback here adds or re-arms for right now wait for the next round, so a zero-interval timer
+    // can't keep the loop from getting to its fds.
+    u64 last_sequence = m_next_timer_sequence;
+    while (!m_timers.is_empty() && m_timers[0]->m_deadline <= now && m_timers[0]->m_sequence < last_sequence) {
+        auto timer = pop_timer();
+        if (!timer->m_active)
+            continue;
+
+        if (timer->m_interval == 0) {
+            // Taking the callback out also means the timer no longer keeps its captures alive once it has fired.
+            auto callback = move(timer->m_callback);
+            timer->m_active = false;
+            timer->m_loop = nullptr;
+            timer_deactivated();
+            TRY(callback());
+            continue;
+        }
+
+        timer->m_deadline = max(timer->m_deadline + timer->m_interval, now);
+        timer->m_sequence = m_next_timer_sequence++;
+        TRY(push_timer(timer));
+        // Call a repeating timer's callback from here, so cancelling the timer from inside the callback doesn't
+        // destroy the callback while it runs, and hand it back afterwards unless it was cancelled.
+        auto callback = move(timer->m_callback);
+        ScopeGuard put_back = [&] {
+            if (timer->m_active)
+                timer->m_callback = move(callback);
+        };
+        TRY(callback());
+    }
+    return {};
+}
+
+i64 EventLoop::milliseconds_until_next_timer(i64 timeout_milliseconds) const
+{
+    while (!m_timers.is_empty() && !m_timers[0]->m_active)
+        (void)pop_timer();
+    if (m_timers.is_empty())
+        return timeout_milliseconds;
+    u64 now = monotonic_milliseconds();
+    u64 deadline = m_timers[0]->m_deadline;
+    i64 until_deadline = deadline <= now ? 0 : static_cast<i64>(deadline - now);
+    if (timeout_milliseconds < 0)
+        return until_deadline;
+    return min(until_deadline, timeout_milliseconds);
+}
+
+ErrorOr<bool> EventLoop::run_once(i64 timeout_milliseconds) const
+{
+    i64 timeout = milliseconds_until_next_timer(timeout_milliseconds);
+    struct epoll_event events[max_events_per_wait];
+    int count = epoll_wait(m_epoll_fd, events, max_events_per_wait, static_cast<int>(min<i64>(timeout, NumericLimits<int>::max())));
+    if (count == -1 && errno != EINTR)
+        return Error::from_errno(errno);
+
+    for (int i = 0; i < count; ++i) {
+        i32 fd = events[i].data.fd;
+        u32 ready = events[i].events;
+        // An earlier callback in this batch may have unwatched (or even closed and reused) this fd. Looking the
+        // callbacks up again each time means only currently watched ones get called.
+        bool readable = ready & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR);
+        bool writable = ready & (EPOLLOUT | EPOLLHUP | EPOLLERR);
+        if (readable && static_cast<size_t>(fd) < m_watchers.size()) {
+            if (auto callback = m_watchers[fd].on_readable)
+                TRY(callback->callback());
+        }
+        if (writable && static_cast<size_t>(fd) < m_watchers.size()) {
+            if (auto callback = m_watchers[fd].on_writable)
+                TRY(callback->callback());
+        }
+    }
+
+    TRY(fire_expired_timers());
+    return m_watched_count > 0 || m_active_timer_count > 0;
+}
+
+ErrorOr<void> EventLoop::run() const
+{
+    m_stopped = false;
+    while (!m_stopped && (m_watched_count > 0 || m_active_timer_count > 0))
+        TRY(run_once(-1));
+    return {};
+}
+
+ErrorOr<void> set_nonblocking(i32 fd)
+{
+    int flags = fcntl(fd, F_GETFL);
+    if (flags == -1)
+        return Error::from_errno(errno);
+    if (fcntl(fd, F_SETFL, flags | O_NONBLOCK) == -1)
+        return Error::from_errno(errno);
+    return {};
+}
+
+ErrorOr<NonnullRefPtr<Stream>> Stream::create(NonnullRefPtr<EventLoop> loop, i32 fd)
+{
+    ScopeGuard close_on_error = [&] {
+        if (fd != -1)
+            ::close(fd);
+    };
+    TRY(set_nonblocking(fd));
+    if (fcntl(fd, F_SETFD, FD_CLOEXEC) == -1)
+        return Error::from_errno(errno);
+    struct stat fd_stat;
+    if (fstat(fd, &fd_stat) == -1)
+        return Error::from_errno(errno);
+    auto write_buffer = TRY(Array<u8>::create_empty());
+    auto stream = TRY(adopt_nonnull_ref_or_enomem(new (nothrow) Stream(move(loop), fd, S_ISSOCK(fd_stat.st_mode), move(write_buffer))));
+    fd = -1;
+    return stream;
+}
+
+Stream::~Stream()
+{
+    // A stream that is being read from or written to is kept alive by the loop, so this one isn't watched.
+    if (m_fd != -1)
+        ::close(m_fd);
+}
+
+ErrorOr<void> Stream::start_reading(Function<ErrorOr<void>(Array<u8>)> on_data, Function<ErrorOr<void>()> on_end) const
+{
+    if (is_closed())
+        return Error::from_errno(EBADF);
+    m_on_data = TRY(adopt_nonnull_ref_or_enomem(new (nothrow) SharedCallback<ErrorOr<void>(Array<u8>)>(move(on_data))));
+    m_on_end = TRY(adopt_nonnull_ref_or_enomem(new (nothrow) SharedCallback<ErrorOr<void>()>(move(on_end))));
+    // The callback holds a reference to the stream, which is what keeps it alive while it is being read.
+    return m_loop->watch_readable(m_fd, [self = NonnullRefPtr<Stream>(*this)]() mutable { return self->handle_readable(); });
+}
+
+ErrorOr<void> Stream::stop_reading() const
+{
+    m_on_data = nullptr;
+    m_on_end = nullptr;
+    if (is_closed())
+        return {};
+    return m_loop->unwatch_readable(m_fd);
+}
+
+ErrorOr<void> Stream::handle_readable() const
+{
+    u8 buffer[read_chunk_size];
+    ssize_t nread = ::read(m_fd, buffer, sizeof(buffer));
+    if (nread == -1) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+            return {};
+        // Treat a reset connection like the other end closing it.
+        if (errno != ECONNRESET)
+            return Error::from_errno(errno);
+        nread = 0;
+    }
+
+    if (nread == 0) {
+        auto on_end = m_on_end;
+        TRY(stop_reading());
+        if (on_end)
+            TRY(on_end->callback());
+        return {};
+    }
+
+    auto bytes = TRY(Array<u8>::create_empty());
+    TRY(bytes.push_values(buffer, static_cast<size_t>(nread)));
+    if (auto on_data = m_on_data)
+        TRY(on_data->callback(move(bytes)));
+    return {};
+}
+
+ErrorOr<void> Stream::write(Array<u8> bytes) const
+{
+    if (is_closed())
+        return Error::from_errno(EBADF);
+
+    u8 const* data = bytes.unsafe_data();
+    size_t size = bytes.size();
+    // Only write directly when nothing is buffered, so the bytes go out in order.
+    if (buffered_size() == 0 && !m_connecting) {
+        while (size > 0) {
+            ssize_t nwritten = write_some(data, size);
+            if (nwritten == -1) {
+                if (errno == EINTR)
+                    continue;
+                if (errno == EAGAIN || errno == EWOULDBLOCK)
+                    break;
+                return Error::from_errno(errno);
+            }
+            data += nwritten;
+            size -= static_cast<size_t>(nwritten);
+        }
+        if (size == 0)
+            return {};
+    }
+
+    TRY(m_write_buffer.push_values(data, size));
+    if (!m_watching_writable) {
+        // As for reading, the callback keeps the stream alive until the buffer has been written out.
+        TRY(m_loop->watch_writable(m_fd, [self = NonnullRefPtr<Stream>(*this)]() mutable { return self->handle_writable(); }));
+        m_watching_writable = true;
+    }
+    return {};
+}
+
+ErrorOr<void> Stream::write_string(String const& string) const
+{
+    auto bytes = TRY(Array<u8>::create_empty());
+    TRY(bytes.push_values(reinterpret_cast<u8 const*>(string.c_string()), string.length()));
+    return write(move(bytes));
+}
+
+ssize_t Stream::write_some(u8 const* data, size_t size) const
+{
+    if (m_is_socket)
+        return ::send(m_fd, data, size, MSG_NOSIGNAL);
+    return ::write(m_fd, data, size);
+}
+
+ErrorOr<void> Stream::flush() const
+{
+    while (buffered_size() > 0) {
+        ssize_t nwritten = write_some(m_write_buffer.unsafe_data() + m_write_offset, buffered_size());
+        if (nwritten == -1) {
+            if (errno == EINTR)
+                continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+                break;
+            return Error::from_errno(errno);
+        }
+        m_write_offset += static_cast<size_t>(nwritten);
+    }
+
+    if (buffered_size() == 0) {
+        m_write_buffer.shrink(0);
+        m_write_offset = 0;
+    } else if (m_write_offset > m_write_buffer.size() / 2) {
+        // Move the unwritten bytes to the front once the written ones are the bigger half, so the buffer doesn't
+        // grow without bound while the reader keeps up.
+        __builtin_memmove(m_write_buffer.unsafe_data(), m_write_buffer.unsafe_data() + m_write_offset, buffered_size());
+        m_write_buffer.shrink(buffered_size());
+        m_write_offset = 0;
+    }
+    return {};
+}
+
+ErrorOr<void> Stream::start_connecting() const
+{
+    m_connecting = true;
+    // Writable is how epoll reports that the connection attempt is over, one way or the other.
+    TRY(m_loop->watch_writable(m_fd, [self = NonnullRefPtr<Stream>(*this)]() mutable { return self->handle_writable(); }));
+    m_watching_writable = true;
+    return {};
+}
+
+ErrorOr<void> Stream::finish_connecting() const
+{
+    m_connecting = false;
+    int error = 0;
+    socklen_t error_length = sizeof(error);
+    if (getsockopt(m_fd, SOL_SOCKET, SO_ERROR, &error, &error_length) == -1)
+        return Error::from_errno(errno);
+    if (error != 0) {
+        // Nothing buffered can be sent now, and the loop shouldn't keep calling back about it.
+        m_watching_writable = false;
+        TRY(m_loop->unwatch_writable(m_fd));
+        return Error::from_errno(error);
+    }
+    return {};
+}
+
+ErrorOr<void> Stream::handle_writable() const
+{
+    if (m_connecting)
+        TRY(finish_connecting());
+    TRY(flush());
+    if (buffered_size() > 0)
+        return {};
+    m_watching_writable = false;
+    // Keep the stream alive until the end of this function; unwatching drops the loop's reference to it.
+    NonnullRefPtr<Stream> protect(*this);
+    TRY(m_loop->unwatch_writable(m_fd));
+    return drained();
+}
+
+ErrorOr<void> Stream::drained() const
+{
+    auto on_drained = move(m_on_drained);
+    if (on_drained)
+        TRY(on_drained->callback());
+    // The callback may have written more, or closed the stream.
+    if (m_end_when_drained && !is_closed() && buffered_size() == 0)
+        return finish_writing();
+    return {};
+}
+
+ErrorOr<void> Stream::end() const
+{
+    if (is_closed())
+        return {};
+    if (buffered_size() > 0 || m_connecting) {
+        m_end_when_drained = true;
+        return {};
+    }
+    return finish_writing();
+}
+
+ErrorOr<void> Stream::finish_writing() const
+{
+    m_end_when_drained = false;
+    if (::shutdown(m_fd, SHUT_WR) == 0)
+        return {};
+    if (errno == ENOTSOCK)
+        return close();
+    return Error::from_errno(errno);
+}
+
+ErrorOr<void> Stream::on_drained(Function<ErrorOr<void>()> callback) const
+{
+    m_on_drained = TRY(adopt_nonnull_ref_or_enomem(new (nothrow) SharedCallback<ErrorOr<void>()>(move(callback))));
+    if (buffered_size() == 0 && !m_connecting)
+        return drained();
+    return {};
+}
+
+ErrorOr<void> Stream::close() const
+{
+    if (is_closed())
+        return {};
+    NonnullRefPtr<Stream> protect(*this);
+    m_on_data = nullptr;
+    m_on_end = nullptr;
+    m_on_drained = nullptr;
+    m_write_buffer.shrink(0);
+    m_write_offset = 0;
+    m_watching_writable = false;
+    m_end_when_drained = false;
+    auto result = m_loop->unwatch(m_fd);
+    ::close(exchange(m_fd, -1));
+    return result;
+}
+
+ErrorOr<NonnullRefPtr<Listener>> Listener::start(NonnullRefPtr<EventLoop> loop, i32 fd, u16 port, Function<ErrorOr<void>(NonnullRefPtr<Stream>)> on_connection)
+{
+    ScopeGuard close_on_error = [&] {
+        if (fd != -1)
+            ::close(fd);
+    };
+    if (::listen(fd, SOMAXCONN) == -1)
+        return Error::from_errno(errno);
+    TRY(set_nonblocking(fd));
+    auto listener = TRY(adopt_nonnull_ref_or_enomem(new (nothrow) Listener(loop, fd, port)));
+    fd = -1;
+    listener->m_on_connection = TRY(adopt_nonnull_ref_or_enomem(new (nothrow) SharedCallback<ErrorOr<void>(NonnullRefPtr<Stream>)>(move(on_connection))));
+    TRY(loop->watch_readable(listener->m_fd, [self = listener]() mutable { return self->accept_all(); }));
+    return listener;
+}
+
+ErrorOr<NonnullRefPtr<Listener>> Listener::listen_unix(NonnullRefPtr<EventLoop> loop, String path, Function<ErrorOr<void>(NonnullRefPtr<Stream>)> on_connection)
+{
+    struct sockaddr_un address { };
+    address.sun_family = AF_UNIX;
+    if (path.length() >= sizeof(address.sun_path))
+        return Error::from_errno(ENAMETOOLONG);
+    __builtin_memcpy(address.sun_path, path.c_string(), path.length());
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd == -1)
+        return Error::from_errno(errno);
+    ::unlink(path.c_string());
+    if (::bind(fd, reinterpret_cast<struct sockaddr*>(&address), sizeof(address)) == -1) {
+        int error = errno;
+        ::close(fd);
+        return Error::from_errno(error);
+    }
+    return start(move(loop), fd, 0, move(on_connection));
+}
+
+static ErrorOr<struct sockaddr_in> ipv4_address(String const& address, u16 port)
+{
+    struct sockaddr_in result { };
+    result.sin_family = AF_INET;
+    result.sin_port = htons(port);
+    if (inet_pton(AF_INET, address.c_string(), &result.sin_addr) != 1)
+        return Error::from_errno(EINVAL);
+    return result;
+}
+
+ErrorOr<NonnullRefPtr<Listener>> Listener::listen_tcp(NonnullRefPtr<EventLoop> loop, String address, u16 port, Function<ErrorOr<void>(NonnullRefPtr<Stream>)> on_connection)
+{
+    auto socket_address = TRY(ipv4_address(address, port));
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd == -1)
+        return Error::from_errno(errno);
+    int reuse = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    socklen_t length = sizeof(socket_address);
+    if (::bind(fd, reinterpret_cast<struct sockaddr*>(&socket_address), length) == -1
+        || getsockname(fd, reinterpret_cast<struct sockaddr*>(&socket_address), &length) == -1) {
+        int error = errno;
+        ::close(fd);
+        return Error::from_errno(error);
+    }
+    return start(move(loop), fd, ntohs(socket_address.sin_port), move(on_connection));
+}
+
+Listener::~Listener()
+{
+    if (m_fd != -1)
+        ::close(m_fd);
+}
+
+ErrorOr<void> Listener::accept_all() const
+{
+    NonnullRefPtr<Listener> protect(*this);
+    while (m_fd != -1) {
+        int fd = accept4(m_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd == -1) {
+            if (errno == EINTR || errno == ECONNABORTED)
+                continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+                return {};
+            return Error::from_errno(errno);
+        }
+        auto stream = TRY(Stream::create(m_loop, fd));
+        if (auto on_connection = m_on_connection)
+            TRY(on_connection->callback(move(stream)));
+    }
+    return {};
+}
+
+ErrorOr<void> Listener::close() const
+{
+    if (m_fd == -1)
+        return {};
+    NonnullRefPtr<Listener> protect(*this);
+    m_on_connection = nullptr;
+    auto result = m_loop->unwatch(m_fd);
+    ::close(exchange(m_fd, -1));
+    return result;
+}
+
+ErrorOr<NonnullRefPtr<Stream>> Stream::connect(NonnullRefPtr<EventLoop> loop, i32 fd, struct sockaddr const* address, u32 length)
+{
+    // The stream makes the socket non-blocking, so connecting doesn't hold up the loop's thread.
+    auto stream = TRY(Stream::create(move(loop), fd));
+    if (::connect(fd, address, length) == 0)
+        return stream;
+    // A non-blocking connect that was interrupted carries on in the background, like one in progress.
+    if (errno != EINPROGRESS && errno != EINTR)
+        return Error::from_errno(errno);
+    TRY(stream->start_connecting());
+    return stream;
+}
+
+ErrorOr<NonnullRefPtr<Stream>> connect_unix(NonnullRefPtr<EventLoop> loop, String path)
+{
+    struct sockaddr_un address { };
+    address.sun_family = AF_UNIX;
+    if (path.length() >= sizeof(address.sun_path))
+        return Error::from_errno(ENAMETOOLONG);
+    __builtin_memcpy(address.sun_path, path.c_string(), path.length());
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd == -1)
+        return Error::from_errno(errno);
+    return Stream::connect(move(loop), fd, reinterpret_cast<struct sockaddr const*>(&address), sizeof(address));
+}
+
+ErrorOr<NonnullRefPtr<Stream>> connect_tcp(NonnullRefPtr<EventLoop> loop, String address, u16 port)
+{
+    auto socket_address = TRY(ipv4_address(address, port));
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd == -1)
+        return Error::from_errno(errno);
+    return Stream::connect(move(loop), fd, reinterpret_cast<struct sockaddr const*>(&socket_address), sizeof(socket_address));
+}
+
+static ErrorOr<Tuple<NonnullRefPtr<Stream>, NonnullRefPtr<Stream>>> stream_pair(NonnullRefPtr<EventLoop> const& loop, int fds[2])
+{
+    auto first = Stream::create(loop, fds[0]);
+    if (first.is_error()) {
+        ::close(fds[1]);
+        return first.release_error();
+    }
+    auto second = TRY(Stream::create(loop, fds[1]));
+    return Tuple<NonnullRefPtr<Stream>, NonnullRefPtr<Stream>> { first.release_value(), move(second) };
+}
+
+ErrorOr<Tuple<NonnullRefPtr<Stream>, NonnullRefPtr<Stream>>> open_pipe(NonnullRefPtr<EventLoop> loop)
+{
+    int fds[2];
+    if (pipe2(fds, O_CLOEXEC) == -1)
+        return Error::from_errno(errno);
+    return stream_pair(loop, fds);
+}
+
+ErrorOr<Tuple<NonnullRefPtr<Stream>, NonnullRefPtr<Stream>>> open_socket_pair(NonnullRefPtr<EventLoop> loop)
+{
+    int fds[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds) == -1)
+        return Error::from_errno(errno);
+    return stream_pair(loop, fds);
+}
+
+}
@@ -0,0 +1,255 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <Builtins/Array.h>
+#include <Jakt/Error.h>
+#include <Jakt/Function.h>
+#include <Jakt/NonnullRefPtr.h>
+#include <Jakt/RefCounted.h>
+#include <Jakt/RefPtr.h>
+#include <Jakt/String.h>
+#include <Jakt/Tuple.h>
+
+struct sockaddr;
+
+namespace JaktInternal {
+
+class EventLoop;
+
+// A callback that can be called while it is being replaced or removed: whoever calls it holds a reference.
+template<typename Signature>
+struct SharedCallback final : public RefCounted<SharedCallback<Signature>> {
+    explicit SharedCallback(Function<Signature> callback)
+        : callback(move(callback))
+    {
+    }
+
+    Function<Signature> callback;
+};
+
+// Returned by EventLoop::add_timer(). The loop keeps the timer until it has fired for the last time or is cancelled.
+class Timer final : public RefCounted<Timer> {
+public:
+    void cancel() const;
+    bool is_active() const { return m_active; }
+
+private:
+    friend class EventLoop;
+
+    Timer(EventLoop const& loop, u64 deadline, u64 interval, u64 sequence, Function<ErrorOr<void>()> callback)
+        : m_loop(&loop)
+        , m_deadline(deadline)
+        , m_interval(interval)
+        , m_sequence(sequence)
+        , m_callback(move(callback))
+    {
+    }
+
+    // Null once the timer is no longer active, which also keeps a cancelled timer from reaching a dead loop.
+    mutable EventLoop const* m_loop { nullptr };
+    u64 m_deadline { 0 };
+    // Zero for a timer that fires only once.
+    u64 m_interval { 0 };
+    // Orders timers with the same deadline by when they were added.
+    u64 m_sequence { 0 };
+    bool mutable m_active { true };
+    Function<ErrorOr<void>()> mutable m_callback;
+};
+
+// Waits for file descriptors to become readable or writable and for timers to expire, and calls their callbacks
+// on the thread that runs it. File descriptors are watched with epoll, level-triggered, so a callback that doesn't
+// read (or write) everything it can is simply called again on the next round. Timers are kept in a binary heap
+// keyed by their deadline on the monotonic clock, and bound how long each epoll_wait() may sleep.
+//
+// An error returned by a callback stops run() and is returned from it; the loop can be run again afterwards.
+class EventLoop final : public RefCounted<EventLoop> {
+public:
+    static ErrorOr<NonnullRefPtr<EventLoop>> create();
+    ~EventLoop();
+
+    // Calls `callback` whenever `fd` is readable (or has hung up), until unwatch_readable() or unwatch(). Watching
+    // an fd again replaces its callback. The fd must stay open while it is watched.
+    ErrorOr<void> watch_readable(i32 fd, Function<ErrorOr<void>()> callback) const;
+    ErrorOr<void> watch_writable(i32 fd, Function<ErrorOr<void>()> callback) const;
+    ErrorOr<void> unwatch_readable(i32 fd) const;
+    ErrorOr<void> unwatch_writable(i32 fd) const;
+    // Stops watching `fd` for anything. Call this before closing a watched fd.
+    ErrorOr<void> unwatch(i32 fd) const;
+
+    // Calls `callback` once `milliseconds` from now and, if `repeat` is set, every `milliseconds` after that.
+    ErrorOr<NonnullRefPtr<Timer>> add_timer(u64 milliseconds, bool repeat, Function<ErrorOr<void>()> callback) const;
+
+    // Dispatches events until stop() is called or nothing is left to wait for: no fd is watched and no timer is
+    // active.
+    ErrorOr<void> run() const;
+    // Waits at most `timeout_milliseconds` (forever if negative) for something to happen, and dispatches it.
+    // Returns whether there is still anything to wait for.
+    ErrorOr<bool> run_once(i64 timeout_milliseconds) const;
+    // Makes run() return once the callback that called this returns.
+    void stop() const { m_stopped = true; }
+
+    size_t watched_count() const { return m_watched_count; }
+    size_t active_timer_count() const { return m_active_timer_count; }
+
+private:
+    friend class Timer;
+
+    struct Watcher {
+        RefPtr<SharedCallback<ErrorOr<void>()>> on_readable;
+        RefPtr<SharedCallback<ErrorOr<void>()>> on_writable;
+    };
+
+    EventLoop(i32 epoll_fd, Array<Watcher> watchers, Array<NonnullRefPtr<Timer>> timers)
+        : m_epoll_fd(epoll_fd)
+        , m_watchers(move(watchers))
+        , m_timers(move(timers))
+    {
+    }
+
+    static bool fires_before(Timer const& a, Timer const& b);
+    ErrorOr<void> update_interest(i32 fd, Watcher const& old_watcher) const;
+    ErrorOr<void> push_timer(NonnullRefPtr<Timer> timer) const;
+    NonnullRefPtr<Timer> pop_timer() const;
+    ErrorOr<void> fire_expired_timers() const;
+    i64 milliseconds_until_next_timer(i64 timeout_milliseconds) const;
+    void timer_deactivated() const;
+
+    i32 m_epoll_fd { -1 };
+    // Indexed by fd, since fds are small and dense.
+    Array<Watcher> mutable m_watchers;
+    size_t mutable m_watched_count { 0 };
+    // A min-heap of the timers by deadline. Cancelled timers stay in it until they reach the top.
+    Array<NonnullRefPtr<Timer>> mutable m_timers;
+    size_t mutable m_active_timer_count { 0 };
+    u64 mutable m_next_timer_sequence { 0 };
+    bool mutable m_stopped { false };
+};
+
+// Switches `fd` to non-blocking mode.
+ErrorOr<void> set_nonblocking(i32 fd);
+
+// A non-blocking fd (a pipe end or a connected socket) read and written through an EventLoop. Reading delivers
+// whatever has arrived to a callback; writing copies what can't be written right away into a buffer that is
+// flushed as the fd becomes writable. While it is reading or has buffered data, the loop keeps the stream alive;
+// the stream closes its fd when it is closed or destroyed.
+class Stream final : public RefCounted<Stream> {
+public:
+    // Takes ownership of `fd`, and makes it non-blocking.
+    static ErrorOr<NonnullRefPtr<Stream>> create(NonnullRefPtr<EventLoop> loop, i32 fd);
+    ~Stream();
+
+    i32 fd() const { return m_fd; }
+    bool is_closed() const { return m_fd == -1; }
+
+    // Calls `on_data` with each chunk read, and `on_end` once the other end has closed (after which reading stops).
+    ErrorOr<void> start_reading(Function<ErrorOr<void>(Array<u8>)> on_data, Function<ErrorOr<void>()> on_end) const;
+    ErrorOr<void> stop_reading() const;
+
+    // Writes as much of `bytes` as the fd takes now, and buffers the rest.
+    ErrorOr<void> write(Array<u8> bytes) const;
+    ErrorOr<void> write_string(String const& string) const;
+    size_t buffered_size() const { return m_write_buffer.size() - m_write_offset; }
+    // Calls `callback` once everything written so far has been handed to the kernel (right away if it has).
+    ErrorOr<void> on_drained(Function<ErrorOr<void>()> callback) const;
+
+    // Stops writing once everything buffered has been written, waiting for a connection in progress to be made
+    // first. Then shuts down the sending side of a socket, so the other end reads the end of the stream while this
+    // one can still read, or closes any other fd.
+    ErrorOr<void> end() const;
+
+    // Closes the fd, dropping anything not yet written, and forgets the callbacks.
+    ErrorOr<void> close() const;
+
+private:
+    friend ErrorOr<NonnullRefPtr<Stream>> connect_unix(NonnullRefPtr<EventLoop>, String);
+    friend ErrorOr<NonnullRefPtr<Stream>> connect_tcp(NonnullRefPtr<EventLoop>, String, u16);
+
+    Stream(NonnullRefPtr<EventLoop> loop, i32 fd, bool is_socket, Array<u8> write_buffer)
+        : m_loop(move(loop))
+        , m_fd(fd)
+        , m_is_socket(is_socket)
+        , m_write_buffer(move(write_buffer))
+    {
+    }
+
+    static ErrorOr<NonnullRefPtr<Stream>> connect(NonnullRefPtr<EventLoop> loop, i32 fd, struct sockaddr const* address, u32 length);
+    ErrorOr<void> start_connecting() const;
+    ErrorOr<void> finish_connecting() const;
+    ErrorOr<void> handle_readable() const;
+    ErrorOr<void> handle_writable() const;
+    ssize_t write_some(u8 const* data, size_t size) const;
+    ErrorOr<void> flush() const;
+    ErrorOr<void> drained() const;
+    ErrorOr<void> finish_writing() const;
+
+    NonnullRefPtr<EventLoop> m_loop;
+    i32 mutable m_fd { -1 };
+    // Sockets are written with send(), so that a closed connection fails with EPIPE rather than raising SIGPIPE.
+    bool m_is_socket { false };
+    // Until a connection started by connect_unix() or connect_tcp() is made, everything written is buffered.
+    bool mutable m_connecting { false };
+    RefPtr<SharedCallback<ErrorOr<void>(Array<u8>)>> mutable m_on_data;
+    RefPtr<SharedCallback<ErrorOr<void>()>> mutable m_on_end;
+    RefPtr<SharedCallback<ErrorOr<void>()>> mutable m_on_drained;
+    Array<u8> mutable m_write_buffer;
+    size_t mutable m_write_offset { 0 };
+    bool mutable m_watching_writable { false };
+    bool mutable m_end_when_drained { false };
+};
+
+// A listening socket that accepts connections as they arrive, and hands each one to a callback as a Stream.
+class Listener final : public RefCounted<Listener> {
+public:
+    // Listens on the Unix socket `path`, replacing a stale socket file there.
+    static ErrorOr<NonnullRefPtr<Listener>> listen_unix(NonnullRefPtr<EventLoop> loop, String path, Function<ErrorOr<void>(NonnullRefPtr<Stream>)> on_connection);
+    // Listens on the IPv4 `address` and `port`; port 0 picks a free one, see port().
+    static ErrorOr<NonnullRefPtr<Listener>> listen_tcp(NonnullRefPtr<EventLoop> loop, String address, u16 port, Function<ErrorOr<void>(NonnullRefPtr<Stream>)> on_connection);
+    ~Listener();
+
+    u16 port() const { return m_port; }
+    ErrorOr<void> close() const;
+
+private:
+    Listener(NonnullRefPtr<EventLoop> loop, i32 fd, u16 port)
+        : m_loop(move(loop))
+        , m_fd(fd)
+        , m_port(port)
+    {
+    }
+
+    static ErrorOr<NonnullRefPtr<Listener>> start(NonnullRefPtr<EventLoop> loop, i32 fd, u16 port, Function<ErrorOr<void>(NonnullRefPtr<Stream>)> on_connection);
+    ErrorOr<void> accept_all() const;
+
+    NonnullRefPtr<EventLoop> m_loop;
+    i32 mutable m_fd { -1 };
+    u16 m_port { 0 };
+    RefPtr<SharedCallback<ErrorOr<void>(NonnullRefPtr<Stream>)>> mutable m_on_connection;
+};
+
+// Start connecting to a listening socket and return without waiting for the connection: whatever is written to the
+// stream meanwhile is buffered until it is made. A connection that can't be made is an error returned from the
+// loop's run().
+ErrorOr<NonnullRefPtr<Stream>> connect_unix(NonnullRefPtr<EventLoop> loop, String path);
+ErrorOr<NonnullRefPtr<Stream>> connect_tcp(NonnullRefPtr<EventLoop> loop, String address, u16 port);
+
+// A pipe, as its read end and its write end.
+ErrorOr<Tuple<NonnullRefPtr<Stream>, NonnullRefPtr<Stream>>> open_pipe(NonnullRefPtr<EventLoop> loop);
+// Two connected Unix sockets, each of which can be read and written.
+ErrorOr<Tuple<NonnullRefPtr<Stream>, NonnullRefPtr<Stream>>> open_socket_pair(NonnullRefPtr<EventLoop> loop);
+
+}
+
+namespace Jakt {
+using JaktInternal::connect_tcp;
+using JaktInternal::connect_unix;
+using JaktInternal::EventLoop;
+using JaktInternal::Listener;
+using JaktInternal::open_pipe;
+using JaktInternal::open_socket_pair;
+using JaktInternal::set_nonblocking;
+using JaktInternal::Stream;
+using JaktInternal::Timer;
+}
@@ -104,6 +104,18 @@ ErrorOr<size_t> File::write(Array<u8> data)
     return nwritten;
 }
 
+ErrorOr<void> File::write_all(Span<u8 const> bytes)
+{
+    size_t offset = 0;
+    while (offset < bytes.size()) {
+        auto nwritten = fwrite(bytes.data() + offset, 1, bytes.size() - offset, m_stdio_file);
+        if (nwritten == 0)
+            return Error::from_errno(ferror(m_stdio_file));
+        offset += nwritten;
+    }
+    return {};
+}
+
 bool File::exists(String path)
 {
 #ifdef _WIN32
@@ -9,6 +9,7 @@
 #include <Builtins/Array.h>
 #include <Jakt/Error.h>
 #include <Jakt/RefCounted.h>
+#include <Jakt/Span.h>
 #include <Jakt/String.h>
 #include <stdio.h>
 
@@ -20,6 +21,8 @@ public:
 
     ErrorOr<size_t> read(Array<u8>);
     ErrorOr<size_t> write(Array<u8>);
+    // Unlike write(), keeps writing until all of `bytes` is written or an error occurs.
+    ErrorOr<void> write_all(Span<u8 const> bytes);
 
     ErrorOr<Array<u8>> read_all();
 
@@ -0,0 +1,129 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Jakt/Arena.h>
+#include <Jakt/Assertions.h>
+#include <Jakt/StdLibExtras.h>
+#include <Jakt/kmalloc.h>
+
+namespace JaktInternal {
+
+static constexpr size_t arena_alignment = 16;
+static constexpr size_t first_region_size = 64 * KiB;
+static constexpr size_t largest_region_size = 16 * MiB;
+static constexpr size_t largest_spare_bytes = 32 * MiB;
+
+// Regions of scopes that ended, kept for the thread's next scopes, so that a loop over short scopes doesn't keep
+// getting fresh memory from malloc and faulting it in.
+struct SpareRegions {
+    ArenaScope::Region* first { nullptr };
+    size_t bytes { 0 };
+
+    ~SpareRegions()
+    {
+        while (first) {
+            auto* previous = first->previous;
+            free(first);
+            first = previous;
+        }
+    }
+};
+
+static thread_local SpareRegions s_spare_regions;
+
+thread_local ArenaScope* ArenaScope::s_current { nullptr };
+
+ArenaScope::ArenaScope()
+    : m_outer(s_current)
+    , m_next_region_size(first_region_size)
+{
+    s_current = this;
+}
+
+ArenaScope::~ArenaScope()
+{
+    VERIFY(s_current == this);
+    s_current = m_outer;
+
+    while (m_regions) {
+        auto* previous = m_regions->previous;
+        auto size = static_cast<size_t>(m_regions->end - m_regions->begin);
+        if (s_spare_regions.bytes + size <= largest_spare_bytes) {
+            m_regions->previous = s_spare_regions.first;
+            s_spare_regions.first = m_regions;
+            s_spare_regions.bytes += size;
+        } else {
+            free(m_regions);
+        }
+        m_regions = previous;
+    }
+}
+
+ArenaScope::Region* ArenaScope::allocate_region(size_t minimum_size)
+{
+    for (auto** link = &s_spare_regions.first; *link; link = &(*link)->previous) {
+        auto* region = *link;
+        auto size = static_cast<size_t>(region->end - region->begin);
+        if (size < minimum_size)
+            continue;
+        *link = region->previous;
+        s_spare_regions.bytes -= size;
+        region->previous = m_regions;
+        m_regions = region;
+        return region;
+    }
+
+    constexpr size_t region_header_size = (sizeof(Region) + arena_alignment - 1) & ~(arena_alignment - 1);
+    auto* memory = static_cast<u8*>(malloc(region_header_size + minimum_size));
+    if (!memory)
+        return nullptr;
+    auto* region = reinterpret_cast<Region*>(memory);
+    region->previous = m_regions;
+    region->begin = memory + region_header_size;
+    region->end = region->begin + minimum_size;
+    m_regions = region;
+    return region;
+}
+
+void* ArenaScope::allocate(size_t size)
+{
+    size = max((size + arena_alignment - 1) & ~(arena_alignment - 1), arena_alignment);
+
+    if (static_cast<size_t>(m_end - m_next) < size) {
+        // Big blocks get a region of their own, so they don't cut the current one short.
+        if (size > m_next_region_size / 4) {
+            auto* region = allocate_region(size);
+            if (!region)
+                return nullptr;
+            m_bytes_allocated += size;
+            return region->begin;
+        }
+
+        auto* region = allocate_region(m_next_region_size);
+        if (!region)
+            return nullptr;
+        m_next = region->begin;
+        m_end = region->end;
+        m_next_region_size = min(m_next_region_size * 2, largest_region_size);
+    }
+
+    auto* block = m_next;
+    m_next += size;
+    m_bytes_allocated += size;
+    return block;
+}
+
+bool ArenaScope::contains(void const* ptr) const
+{
+    auto const* address = static_cast<u8 const*>(ptr);
+    for (auto const* scope = this; scope; scope = scope->m_outer) {
+        for (auto const* region = scope->m_regions; region; region = region->previous) {
+            if (address >= region->begin && address < region->end)
+                return true;
+        }
+    }
+    return false;
+}
+
+}
@@ -0,0 +1,70 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <Jakt/Error.h>
+#include <Jakt/Function.h>
+#include <Jakt/Noncopyable.h>
+#include <Jakt/Types.h>
+
+namespace JaktInternal {
+using namespace Jakt;
+
+// While an ArenaScope is alive, kmalloc_slab() on its thread bumps through regions owned by the scope instead of
+// using the size-class free lists, and kfree_slab() leaves blocks from those regions alone; the regions are all
+// released when the scope ends. Objects are still reference counted and destroyed as usual, so nothing allocated
+// in the scope may be freed after it ends, and nothing may be freed on another thread. Scopes nest.
+class ArenaScope {
+    AK_MAKE_NONCOPYABLE(ArenaScope);
+    AK_MAKE_NONMOVABLE(ArenaScope);
+
+public:
+    ArenaScope();
+    ~ArenaScope();
+
+    // The innermost scope alive on this thread, if any.
+    static ArenaScope* current() { return s_current; }
+
+    void* allocate(size_t size);
+
+    // Whether `ptr` points into one of the regions of this scope or of the scopes it is nested in.
+    bool contains(void const* ptr) const;
+
+    size_t bytes_allocated() const { return m_bytes_allocated; }
+
+    // The header of each malloc'd block a scope bumps through.
+    struct Region {
+        Region* previous;
+        u8* begin;
+        u8* end;
+    };
+
+private:
+    Region* allocate_region(size_t minimum_size);
+
+    static thread_local ArenaScope* s_current;
+
+    ArenaScope* m_outer { nullptr };
+    Region* m_regions { nullptr };
+    u8* m_next { nullptr };
+    u8* m_end { nullptr };
+    size_t m_next_region_size;
+    size_t m_bytes_allocated { 0 };
+};
+
+// Runs `body` inside an ArenaScope. Jakt code reaches this through jakt::arena, whose typechecking makes sure the
+// body only captures plain values (no strings, containers, objects or pointers), however it captures them.
+inline ErrorOr<void> with_arena(Function<ErrorOr<void>()> const& body)
+{
+    ArenaScope scope;
+    return body();
+}
+
+}
+
+namespace Jakt {
+using JaktInternal::ArenaScope;
+using JaktInternal::with_arena;
+}
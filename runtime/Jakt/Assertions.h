@@ -10,9 +10,13 @@
 #    include <Kernel/Assertions.h>
 #else
 #    include <assert.h>
+namespace Jakt {
+void flush_output();
+}
 #    define _TRAP_NORETURN(expr) \
         []() __attribute__((noreturn)) \
         {                              \
+            Jakt::flush_output();      \
             assert(false && # expr);   \
             __builtin_trap();          \
             __builtin_unreachable();   \
@@ -21,6 +21,11 @@
 #else
 #    include <stdio.h>
 #    include <string.h>
+#    ifdef _WIN32
+#        include <io.h>
+#    else
+#        include <unistd.h>
+#    endif
 #endif
 
 namespace Jakt {
@@ -525,6 +530,13 @@ ErrorOr<void> vformat(StringBuilder& builder, StringView fmtstr, TypeErasedForma
     return {};
 }
 
+void StandardFormatter::parse_flags(StringView flags)
+{
+    TypeErasedFormatParams params;
+    FormatParser parser { flags };
+    parse(params, parser);
+}
+
 void StandardFormatter::parse(TypeErasedFormatParams& params, FormatParser& parser)
 {
     if (StringView { "<^>" }.contains(parser.peek(1))) {
@@ -789,7 +801,34 @@ void vout(FILE* file, StringView fmtstr, TypeErasedFormatParams& params, bool ne
     if (newline)
         MUST(builder.append('\n'));
 
-    auto const string = builder.string_view();
+    out_string(file, builder.string_view());
+}
+
+static constexpr size_t output_buffer_size = 64 * KiB;
+static char stdout_buffer[output_buffer_size];
+
+static bool is_terminal(FILE* file)
+{
+#    ifdef _WIN32
+    return _isatty(_fileno(file));
+#    else
+    return isatty(fileno(file));
+#    endif
+}
+
+void set_up_output_buffering()
+{
+    setvbuf(stdout, stdout_buffer, is_terminal(stdout) ? _IOLBF : _IOFBF, output_buffer_size);
+}
+
+void flush_output()
+{
+    fflush(stdout);
+    fflush(stderr);
+}
+
+void out_string(FILE* file, StringView string)
+{
     auto const retval = ::fwrite(string.characters_without_null_termination(), 1, string.length(), file);
     if (static_cast<size_t>(retval) != string.length()) {
         auto error = ferror(file);
@@ -161,6 +161,8 @@ struct StandardFormatter {
     Optional<size_t> m_precision;
 
     void parse(TypeErasedFormatParams&, FormatParser&);
+    // For flags the compiler has already checked, and that take nothing from the arguments.
+    void parse_flags(StringView flags);
 };
 
 template<typename T, typename>
@@ -447,8 +449,52 @@ struct Formatter<std::nullptr_t> : Formatter<FlatPtr> {
 
 ErrorOr<void> vformat(StringBuilder&, StringView fmtstr, TypeErasedFormatParams&);
 
+// A format string split up by the compiler: literals are written out as they are and each field is formatted
+// straight from its argument, so nothing is parsed or type-erased at runtime. See out_pieces() and formatted_pieces().
+template<typename T>
+struct FormatField {
+    T const& value;
+    StringView flags;
+};
+
+template<typename T>
+FormatField<T> format_field(T const& value, StringView flags = {})
+{
+    return { value, flags };
+}
+
+inline ErrorOr<void> format_piece(FormatBuilder& builder, StringView literal)
+{
+    return builder.put_string(literal);
+}
+
+template<typename T>
+ErrorOr<void> format_piece(FormatBuilder& builder, FormatField<T> const& field)
+{
+    Formatter<T> formatter;
+    if (!field.flags.is_empty())
+        formatter.parse_flags(field.flags);
+    return formatter.format(builder, field.value);
+}
+
+inline ErrorOr<void> format_pieces(FormatBuilder&) { return {}; }
+
+template<typename Piece, typename... Pieces>
+ErrorOr<void> format_pieces(FormatBuilder& builder, Piece const& piece, Pieces const&... pieces)
+{
+    TRY(format_piece(builder, piece));
+    return format_pieces(builder, pieces...);
+}
+
 #ifndef KERNEL
 void vout(FILE*, StringView fmtstr, TypeErasedFormatParams&, bool newline = false);
+void out_string(FILE*, StringView);
+
+// Gives stdout a large buffer: line-buffered when it's a terminal, block-buffered otherwise. stderr stays
+// unbuffered, so nothing written to it is lost if the process dies without exiting. Anything still buffered is
+// written out at exit, by flush_output(), and before a panic or failed VERIFY.
+void set_up_output_buffering();
+void flush_output();
 
 template<typename... Parameters>
 void out(FILE* file, StringView&& fmtstr, Parameters const&... parameters)
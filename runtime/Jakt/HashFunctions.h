@@ -10,15 +10,59 @@
 
 namespace Jakt {
 
+namespace Detail {
+
+// The constants and mixing steps of wyhash (final version 4), by Wang Yi, which is public domain.
+constexpr u64 wyhash_secret[4] = { 0x2d358dccaa6c78a5ull, 0x8bb84b93962eacc9ull, 0x4b33a62ed433d4a3ull, 0x4d5a2da51de1aa47ull };
+
+// Multiplies a and b into 128 bits, and returns the low half in a and the high half in b.
+constexpr void wymum(u64& a, u64& b)
+{
+#ifdef __SIZEOF_INT128__
+    unsigned __int128 product = static_cast<unsigned __int128>(a) * b;
+    a = static_cast<u64>(product);
+    b = static_cast<u64>(product >> 64);
+#else
+    u64 a_high = a >> 32;
+    u64 a_low = static_cast<u32>(a);
+    u64 b_high = b >> 32;
+    u64 b_low = static_cast<u32>(b);
+    u64 high = a_high * b_high;
+    u64 middle_1 = a_high * b_low;
+    u64 middle_2 = a_low * b_high;
+    u64 low = a_low * b_low;
+    u64 carry = static_cast<u64>(static_cast<u32>(middle_1)) + static_cast<u32>(middle_2) + (low >> 32);
+    a = low + (middle_1 << 32) + (middle_2 << 32);
+    b = high + (middle_1 >> 32) + (middle_2 >> 32) + (carry >> 32);
+#endif
+}
+
+constexpr u64 wymix(u64 a, u64 b)
+{
+    wymum(a, b);
+    return a ^ b;
+}
+
+// Folds a well-mixed 64-bit hash into the 32 bits that hash tables use.
+constexpr unsigned fold_hash(u64 hash)
+{
+    return static_cast<unsigned>(hash ^ (hash >> 32));
+}
+
+}
+
+// wyhash64(key, 0): one 64x64->128-bit multiply to mix the key, and another to finalize it.
+constexpr unsigned u64_hash(u64 key)
+{
+    u64 a = key ^ Detail::wyhash_secret[0];
+    u64 b = Detail::wyhash_secret[1];
+    Detail::wymum(a, b);
+    return Detail::fold_hash(Detail::wymix(a ^ Detail::wyhash_secret[0], b ^ Detail::wyhash_secret[1]));
+}
+
 constexpr unsigned int_hash(u32 key)
 {
-    key += ~(key << 15);
-    key ^= (key >> 10);
-    key += (key << 3);
-    key ^= (key >> 6);
-    key += ~(key << 11);
-    key ^= (key >> 16);
-    return key;
+    return u64_hash(key);
 }
 
 constexpr unsigned double_hash(u32 key)
@@ -35,24 +79,15 @@ constexpr unsigned double_hash(u32 key)
     return key;
 }
 
+// Combines two hashes (in order, so swapping them gives a different result) into one.
 constexpr unsigned pair_int_hash(u32 key1, u32 key2)
 {
-    return int_hash((int_hash(key1) * 209) ^ (int_hash(key2 * 413)));
-}
-
-constexpr unsigned u64_hash(u64 key)
-{
-    u32 first = key & 0xFFFFFFFF;
-    u32 last = key >> 32;
-    return pair_int_hash(first, last);
+    return u64_hash(static_cast<u64>(key1) << 32 | key2);
 }
 
 constexpr unsigned ptr_hash(FlatPtr ptr)
 {
-    if constexpr (sizeof(ptr) == 8)
-        return u64_hash(ptr);
-    else
-        return int_hash(ptr);
+    return u64_hash(ptr);
 }
 
 inline unsigned ptr_hash(void const* ptr)
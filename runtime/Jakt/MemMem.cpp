@@ -0,0 +1,92 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Jakt/MemMem.h>
+
+#if ARCH(X86_64)
+
+#    include <immintrin.h>
+
+namespace Jakt::Detail {
+
+// Both variants walk the haystack one block at a time, comparing the block that starts at each candidate position
+// with the needle's first byte and the block that starts needle_length - 1 bytes later with its last byte. Only
+// positions where both match are compared in full, so unlike a memchr() for the first byte, a common first byte
+// doesn't make the search fall back to comparing almost everywhere. Whatever is left over once a whole block no
+// longer fits goes to the scalar search.
+
+static Optional<size_t> memmem_sse2(u8 const* haystack, size_t haystack_length, u8 const* needle, size_t needle_length)
+{
+    auto const first = _mm_set1_epi8(static_cast<char>(needle[0]));
+    auto const last = _mm_set1_epi8(static_cast<char>(needle[needle_length - 1]));
+    size_t const last_start = haystack_length - needle_length;
+
+    size_t position = 0;
+    for (; position + 16 <= last_start + 1; position += 16) {
+        auto block_first = _mm_loadu_si128(reinterpret_cast<__m128i const*>(haystack + position));
+        auto block_last = _mm_loadu_si128(reinterpret_cast<__m128i const*>(haystack + position + needle_length - 1));
+        auto matches = _mm_and_si128(_mm_cmpeq_epi8(block_first, first), _mm_cmpeq_epi8(block_last, last));
+        u32 mask = static_cast<u32>(_mm_movemask_epi8(matches));
+        while (mask != 0) {
+            size_t candidate = position + __builtin_ctz(mask);
+            if (needle_length <= 2 || __builtin_memcmp(haystack + candidate + 1, needle + 1, needle_length - 2) == 0)
+                return candidate;
+            mask &= mask - 1;
+        }
+    }
+
+    auto rest = memmem_scalar(haystack + position, haystack_length - position, needle, needle_length);
+    if (rest.has_value())
+        return position + rest.value();
+    return {};
+}
+
+__attribute__((target("avx2"))) static Optional<size_t> memmem_avx2(u8 const* haystack, size_t haystack_length, u8 const* needle, size_t needle_length)
+{
+    auto const first = _mm256_set1_epi8(static_cast<char>(needle[0]));
+    auto const last = _mm256_set1_epi8(static_cast<char>(needle[needle_length - 1]));
+    size_t const last_start = haystack_length - needle_length;
+
+    size_t position = 0;
+    for (; position + 32 <= last_start + 1; position += 32) {
+        auto block_first = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(haystack + position));
+        auto block_last = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(haystack + position + needle_length - 1));
+        auto matches = _mm256_and_si256(_mm256_cmpeq_epi8(block_first, first), _mm256_cmpeq_epi8(block_last, last));
+        u32 mask = static_cast<u32>(_mm256_movemask_epi8(matches));
+        while (mask != 0) {
+            size_t candidate = position + __builtin_ctz(mask);
+            if (needle_length <= 2 || __builtin_memcmp(haystack + candidate + 1, needle + 1, needle_length - 2) == 0)
+                return candidate;
+            mask &= mask - 1;
+        }
+    }
+
+    auto rest = memmem_sse2(haystack + position, haystack_length - position, needle, needle_length);
+    if (rest.has_value())
+        return position + rest.value();
+    return {};
+}
+
+Optional<size_t> memmem_vectorized(void const* haystack, size_t haystack_length, void const* needle, size_t needle_length)
+{
+    auto const* haystack_bytes = static_cast<u8 const*>(haystack);
+    auto const* needle_bytes = static_cast<u8 const*>(needle);
+
+    // glibc's memchr() is already vectorized (and picks its own variant at load time), so single bytes go there.
+    if (needle_length == 1) {
+        auto const* match = static_cast<u8 const*>(__builtin_memchr(haystack_bytes, needle_bytes[0], haystack_length));
+        if (match)
+            return static_cast<size_t>(match - haystack_bytes);
+        return {};
+    }
+
+    static bool const has_avx2 = __builtin_cpu_supports("avx2");
+    if (has_avx2)
+        return memmem_avx2(haystack_bytes, haystack_length, needle_bytes, needle_length);
+    return memmem_sse2(haystack_bytes, haystack_length, needle_bytes, needle_length);
+}
+
+}
+
+#endif
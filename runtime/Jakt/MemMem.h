@@ -9,6 +9,7 @@
 #include <Jakt/Assertions.h>
 #include <Jakt/LinearArray.h>
 #include <Jakt/Optional.h>
+#include <Jakt/Platform.h>
 #include <Jakt/Span.h>
 #include <Jakt/Types.h>
 
@@ -98,6 +99,29 @@ inline Optional<size_t> memmem(HaystackIterT const& haystack_begin, HaystackIter
     return {};
 }
 
+namespace Detail {
+inline Optional<size_t> memmem_scalar(void const* haystack, size_t haystack_length, void const* needle, size_t needle_length)
+{
+    if (needle_length < 32) {
+        auto const* ptr = Detail::bitap_bitwise(haystack, haystack_length, needle, needle_length);
+        if (ptr)
+            return static_cast<size_t>((FlatPtr)ptr - (FlatPtr)haystack);
+        return {};
+    }
+
+    // Fallback to KMP.
+    LinearArray<Jakt::Span<const u8>, 1> spans { Jakt::Span<const u8> { (u8 const*)haystack, haystack_length } };
+    return memmem(spans.begin(), spans.end(), { (u8 const*)needle, needle_length });
+}
+
+#if ARCH(X86_64)
+// Scans with SSE2, or AVX2 where the CPU has it, for positions where both the first and the last byte of the
+// needle match, and only compares the rest of the needle there. Expects a non-empty needle shorter than the
+// haystack. Defined in MemMem.cpp.
+Optional<size_t> memmem_vectorized(void const* haystack, size_t haystack_length, void const* needle, size_t needle_length);
+#endif
+}
+
 inline Optional<size_t> memmem_optional(void const* haystack, size_t haystack_length, void const* needle, size_t needle_length)
 {
     if (needle_length == 0)
@@ -112,16 +136,11 @@ inline Optional<size_t> memmem_optional(void const* haystack, size_t haystack_le
         return {};
     }
 
-    if (needle_length < 32) {
-        auto const* ptr = Detail::bitap_bitwise(haystack, haystack_length, needle, needle_length);
-        if (ptr)
-            return static_cast<size_t>((FlatPtr)ptr - (FlatPtr)haystack);
-        return {};
-    }
-
-    // Fallback to KMP.
-    LinearArray<Span<const u8>, 1> spans { Span<const u8> { (u8 const*)haystack, haystack_length } };
-    return memmem(spans.begin(), spans.end(), { (u8 const*)needle, needle_length });
+#if ARCH(X86_64)
+    return Detail::memmem_vectorized(haystack, haystack_length, needle, needle_length);
+#else
+    return Detail::memmem_scalar(haystack, haystack_length, needle, needle_length);
+#endif
 }
 
 inline void const* memmem(void const* haystack, size_t haystack_length, void const* needle, size_t needle_length)
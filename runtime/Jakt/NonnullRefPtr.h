@@ -210,6 +210,10 @@ public:
         Jakt::swap(m_ptr, other.m_ptr);
     }
 
+    // Optional<NonnullRefPtr<T>> keeps "no value" as null, which makes it as small and cheap to check as a RefPtr<T>.
+    static void make_optional_niche(NonnullRefPtr* storage) { storage->m_ptr = nullptr; }
+    static bool is_optional_niche(NonnullRefPtr const* storage) { return storage->m_ptr == nullptr; }
+
     // clang-format off
 private:
     NonnullRefPtr() = delete;
@@ -8,6 +8,7 @@
 #pragma once
 
 #include <Jakt/Assertions.h>
+#include <Jakt/Concepts.h>
 #include <Jakt/StdLibExtras.h>
 #include <Jakt/Try.h>
 #include <Jakt/Types.h>
@@ -45,6 +46,26 @@ class Optional;
 
 struct NullOptional { };
 
+// Types with a bit pattern that is never a valid value can specialize OptionalNiche to have Optional store "no value"
+// as that pattern, instead of in a flag of its own. make_empty() writes the pattern into uninitialized storage, and
+// is_empty() checks for it.
+template<typename T>
+struct OptionalNiche;
+
+// Types can also describe their niche themselves, with static make_optional_niche() and is_optional_niche() members.
+template<typename T>
+requires(requires(T* storage, T const* const_storage) { T::make_optional_niche(storage); T::is_optional_niche(const_storage); })
+struct OptionalNiche<T> {
+    static void make_empty(T* storage) { T::make_optional_niche(storage); }
+    static bool is_empty(T const* storage) { return T::is_optional_niche(storage); }
+};
+
+template<typename T>
+concept HasOptionalNiche = requires(T* storage, T const* const_storage) {
+    OptionalNiche<T>::make_empty(storage);
+    { OptionalNiche<T>::is_empty(const_storage) } -> SameAs<bool>;
+};
+
 template<typename T>
 requires(!IsLvalueReference<T>) class [[nodiscard]] Optional<T> {
     template<typename U>
@@ -52,13 +73,20 @@ requires(!IsLvalueReference<T>) class [[nodiscard]] Optional<T> {
 
     static_assert(!IsLvalueReference<T> && !IsRvalueReference<T>);
 
+    static constexpr bool uses_niche = HasOptionalNiche<T>;
+    struct NoFlag { };
+
 public:
     using ValueType = T;
 
-    ALWAYS_INLINE Optional() = default;
+    ALWAYS_INLINE Optional()
+    {
+        set_has_value(false);
+    }
 
     ALWAYS_INLINE Optional(NullOptional)
     {
+        set_has_value(false);
     }
 
 #ifdef AK_HAS_CONDITIONALLY_TRIVIAL
@@ -80,40 +108,42 @@ public:
 #ifdef AK_HAS_CONDITIONALLY_TRIVIAL
         requires(!IsTriviallyCopyConstructible<T>)
 #endif
-        : m_has_value(other.m_has_value)
     {
         if (other.has_value())
             new (&m_storage) T(other.value());
+        set_has_value(other.has_value());
     }
 
     ALWAYS_INLINE Optional(Optional&& other)
-        : m_has_value(other.m_has_value)
     {
-        if (other.has_value())
+        bool const had_value = other.has_value();
+        if (had_value)
             new (&m_storage) T(other.release_value());
+        set_has_value(had_value);
     }
 
     template<typename U>
     requires(IsConstructible<T, U const&> && !IsSpecializationOf<T, Optional> && !IsSpecializationOf<U, Optional>) ALWAYS_INLINE explicit Optional(Optional<U> const& other)
-        : m_has_value(other.m_has_value)
     {
         if (other.has_value())
             new (&m_storage) T(other.value());
+        set_has_value(other.has_value());
     }
 
     template<typename U>
     requires(IsConstructible<T, U&&> && !IsSpecializationOf<T, Optional> && !IsSpecializationOf<U, Optional>) ALWAYS_INLINE explicit Optional(Optional<U>&& other)
-        : m_has_value(other.m_has_value)
     {
-        if (other.has_value())
+        bool const had_value = other.has_value();
+        if (had_value)
             new (&m_storage) T(other.release_value());
+        set_has_value(had_value);
     }
 
     template<typename U = T>
     ALWAYS_INLINE explicit(!IsConvertible<U&&, T>) Optional(U&& value) requires(!IsSame<RemoveCVReference<U>, Optional<T>> && IsConstructible<T, U&&>)
-        : m_has_value(true)
     {
         new (&m_storage) T(forward<U>(value));
+        set_has_value(true);
     }
 
     ALWAYS_INLINE Optional& operator=(Optional const& other)
@@ -123,9 +153,9 @@ public:
     {
         if (this != &other) {
             clear();
-            m_has_value = other.m_has_value;
             if (other.has_value()) {
                 new (&m_storage) T(other.value());
+                set_has_value(true);
             }
         }
         return *this;
@@ -135,9 +165,9 @@ public:
     {
         if (this != &other) {
             clear();
-            m_has_value = other.m_has_value;
             if (other.has_value()) {
                 new (&m_storage) T(other.release_value());
+                set_has_value(true);
             }
         }
         return *this;
@@ -165,9 +195,9 @@ public:
 
     ALWAYS_INLINE void clear()
     {
-        if (m_has_value) {
+        if (has_value()) {
             value().~T();
-            m_has_value = false;
+            set_has_value(false);
         }
     }
 
@@ -175,29 +205,35 @@ public:
     ALWAYS_INLINE void emplace(Parameters&&... parameters)
     {
         clear();
-        m_has_value = true;
         new (&m_storage) T(forward<Parameters>(parameters)...);
+        set_has_value(true);
     }
 
     template<typename Callback>
     ALWAYS_INLINE Optional<T>& lazy_emplace(Callback callback)
     {
-        if (!m_has_value)
+        if (!has_value())
             emplace(callback());
         return *this;
     }
 
-    [[nodiscard]] ALWAYS_INLINE bool has_value() const { return m_has_value; }
+    [[nodiscard]] ALWAYS_INLINE bool has_value() const
+    {
+        if constexpr (uses_niche)
+            return !OptionalNiche<T>::is_empty(reinterpret_cast<T const*>(&m_storage));
+        else
+            return m_has_value;
+    }
 
     [[nodiscard]] ALWAYS_INLINE T& value() &
     {
-        VERIFY(m_has_value);
+        VERIFY(has_value());
         return *__builtin_launder(reinterpret_cast<T*>(&m_storage));
     }
 
     [[nodiscard]] ALWAYS_INLINE T const& value() const&
     {
-        VERIFY(m_has_value);
+        VERIFY(has_value());
         return *__builtin_launder(reinterpret_cast<T const*>(&m_storage));
     }
 
@@ -208,23 +244,24 @@ public:
 
     [[nodiscard]] ALWAYS_INLINE T release_value()
     {
-        VERIFY(m_has_value);
+        VERIFY(has_value());
         T released_value = move(value());
-        value().~T();
-        m_has_value = false;
+        // Moving out may have left the niche behind, so don't go through value() again.
+        __builtin_launder(reinterpret_cast<T*>(&m_storage))->~T();
+        set_has_value(false);
         return released_value;
     }
 
     [[nodiscard]] ALWAYS_INLINE T value_or(T const& fallback) const&
     {
-        if (m_has_value)
+        if (has_value())
             return value();
         return fallback;
     }
 
     [[nodiscard]] ALWAYS_INLINE T value_or(T&& fallback) &&
     {
-        if (m_has_value)
+        if (has_value())
             return move(value());
         return move(fallback);
     }
@@ -232,7 +269,7 @@ public:
     template<typename Callback>
     [[nodiscard]] ALWAYS_INLINE T value_or_lazy_evaluated(Callback callback) const
     {
-        if (m_has_value)
+        if (has_value())
             return value();
         return callback();
     }
@@ -240,7 +277,7 @@ public:
     template<typename Callback>
     [[nodiscard]] ALWAYS_INLINE Optional<T> value_or_lazy_evaluated_optional(Callback callback) const
     {
-        if (m_has_value)
+        if (has_value())
             return value();
         return callback();
     }
@@ -248,7 +285,7 @@ public:
     template<typename Callback>
     [[nodiscard]] ALWAYS_INLINE ErrorOr<T> try_value_or_lazy_evaluated(Callback callback) const
     {
-        if (m_has_value)
+        if (has_value())
             return value();
         return TRY(callback());
     }
@@ -256,7 +293,7 @@ public:
     template<typename Callback>
     [[nodiscard]] ALWAYS_INLINE ErrorOr<Optional<T>> try_value_or_lazy_evaluated_optional(Callback callback) const
     {
-        if (m_has_value)
+        if (has_value())
             return value();
         return TRY(callback());
     }
@@ -271,11 +308,11 @@ public:
     ALWAYS_INLINE Conditional<IsErrorOr, ErrorOr<OptionalType>, OptionalType> map(F&& mapper)
     {
         if constexpr (IsErrorOr) {
-            if (m_has_value)
+            if (has_value())
                 return OptionalType { TRY(mapper(value())) };
             return OptionalType {};
         } else {
-            if (m_has_value)
+            if (has_value())
                 return OptionalType { mapper(value()) };
 
             return OptionalType {};
@@ -286,11 +323,11 @@ public:
     ALWAYS_INLINE Conditional<IsErrorOr, ErrorOr<OptionalType>, OptionalType> map(F&& mapper) const
     {
         if constexpr (IsErrorOr) {
-            if (m_has_value)
+            if (has_value())
                 return OptionalType { TRY(mapper(value())) };
             return OptionalType {};
         } else {
-            if (m_has_value)
+            if (has_value())
                 return OptionalType { mapper(value()) };
 
             return OptionalType {};
@@ -298,8 +335,19 @@ public:
     }
 
 private:
+    // Storage must not hold a T when clearing the flag.
+    ALWAYS_INLINE void set_has_value(bool has_value)
+    {
+        if constexpr (uses_niche) {
+            if (!has_value)
+                OptionalNiche<T>::make_empty(reinterpret_cast<T*>(&m_storage));
+        } else {
+            m_has_value = has_value;
+        }
+    }
+
     alignas(T) u8 m_storage[sizeof(T)];
-    bool m_has_value { false };
+    [[no_unique_address]] Conditional<uses_niche, NoFlag, bool> m_has_value {};
 };
 
 template<typename T>
@@ -11,6 +11,7 @@
 #else
 
 #    include <Jakt/Assertions.h>
+#    include <Jakt/Atomic.h>
 #    include <Jakt/Checked.h>
 #    include <Jakt/Noncopyable.h>
 #    include <Jakt/Platform.h>
@@ -18,51 +19,108 @@
 
 namespace Jakt {
 
-class RefCountedBase {
-    AK_MAKE_NONCOPYABLE(RefCountedBase);
-    AK_MAKE_NONMOVABLE(RefCountedBase);
+// Whether a refcount may be shared between threads. Atomic counts cost a locked instruction per reference, so
+// types only use them when built with JAKT_ATOMIC_REFCOUNT (`jakt --atomic-refcount`, against the
+// jakt_runtime_atomic library), or when they are always shared between threads and say so by deriving from
+// AtomicRefCounted.
+enum class RefCountMode {
+    NonAtomic,
+    Atomic,
+};
+
+#    ifdef JAKT_ATOMIC_REFCOUNT
+inline constexpr RefCountMode default_ref_count_mode = RefCountMode::Atomic;
+#    else
+inline constexpr RefCountMode default_ref_count_mode = RefCountMode::NonAtomic;
+#    endif
+
+template<RefCountMode mode>
+class BasicRefCountedBase {
+    AK_MAKE_NONCOPYABLE(BasicRefCountedBase);
+    AK_MAKE_NONMOVABLE(BasicRefCountedBase);
 
 public:
     using RefCountType = unsigned int;
 
+    static constexpr bool is_atomic = mode == RefCountMode::Atomic;
+
     ALWAYS_INLINE void ref() const
     {
-        VERIFY(m_ref_count > 0);
-        VERIFY(!Checked<RefCountType>::addition_would_overflow(m_ref_count, 1));
-        ++m_ref_count;
+        if constexpr (is_atomic) {
+            auto old_ref_count = atomic_fetch_add(&m_ref_count, 1u, memory_order_relaxed);
+            VERIFY(old_ref_count > 0);
+            VERIFY(!Checked<RefCountType>::addition_would_overflow(old_ref_count, 1));
+        } else {
+            VERIFY(m_ref_count > 0);
+            VERIFY(!Checked<RefCountType>::addition_would_overflow(m_ref_count, 1));
+            ++m_ref_count;
+        }
     }
 
     [[nodiscard]] bool try_ref() const
     {
-        if (m_ref_count == 0)
-            return false;
-        ref();
-        return true;
+        if constexpr (is_atomic) {
+            auto expected = atomic_load(&m_ref_count, memory_order_relaxed);
+            for (;;) {
+                if (expected == 0)
+                    return false;
+                VERIFY(!Checked<RefCountType>::addition_would_overflow(expected, 1));
+                if (atomic_compare_exchange_strong(&m_ref_count, expected, expected + 1, memory_order_acquire))
+                    return true;
+            }
+        } else {
+            if (m_ref_count == 0)
+                return false;
+            ref();
+            return true;
+        }
     }
 
-    [[nodiscard]] RefCountType ref_count() const { return m_ref_count; }
+    [[nodiscard]] RefCountType ref_count() const
+    {
+        if constexpr (is_atomic)
+            return atomic_load(&m_ref_count, memory_order_relaxed);
+        else
+            return m_ref_count;
+    }
+
+    // For an owner that destroys the object itself rather than deleting it (see JaktInternal::LocalObject).
+    void release_last_ref() const
+    {
+        VERIFY(ref_count() == 1);
+        m_ref_count = 0;
+    }
 
 protected:
-    RefCountedBase() = default;
-    ~RefCountedBase() { VERIFY(!m_ref_count); }
+    BasicRefCountedBase() = default;
+    ~BasicRefCountedBase() { VERIFY(!m_ref_count); }
 
     ALWAYS_INLINE RefCountType deref_base() const
     {
-        VERIFY(m_ref_count);
-        return --m_ref_count;
+        if constexpr (is_atomic) {
+            // Release our writes to the object, and acquire everyone else's before the last reference destroys it.
+            auto old_ref_count = atomic_fetch_sub(&m_ref_count, 1u, memory_order_acq_rel);
+            VERIFY(old_ref_count);
+            return old_ref_count - 1;
+        } else {
+            VERIFY(m_ref_count);
+            return --m_ref_count;
+        }
     }
 
     RefCountType mutable m_ref_count { 1 };
 };
 
-template<typename T>
-class RefCounted : public RefCountedBase {
+using RefCountedBase = BasicRefCountedBase<default_ref_count_mode>;
+
+template<typename T, RefCountMode mode = default_ref_count_mode>
+class RefCounted : public BasicRefCountedBase<mode> {
 public:
     bool unref() const
     {
         auto* that = const_cast<T*>(static_cast<T const*>(this));
 
-        auto new_ref_count = deref_base();
+        auto new_ref_count = this->deref_base();
         if (new_ref_count == 0) {
             if constexpr (requires { that->will_be_destroyed(); })
                 that->will_be_destroyed();
@@ -73,5 +131,8 @@ public:
     }
 };
 
+template<typename T>
+using AtomicRefCounted = RefCounted<T, RefCountMode::Atomic>;
+
 }
 #endif
@@ -0,0 +1,103 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Jakt/Rope.h>
+#include <Jakt/RefPtr.h>
+
+namespace Jakt {
+
+// Strings shorter than this are copied into the current chunk rather than kept as pieces of their own, where the
+// reference and the bookkeeping would cost more than the copy.
+static constexpr size_t shared_piece_threshold = 64;
+static constexpr size_t chunk_capacity = 4096;
+
+ErrorOr<NonnullRefPtr<Rope>> Rope::create()
+{
+    auto pieces = TRY(Array<String>::create_empty());
+    auto chunk = TRY(Array<u8>::create_empty());
+    return adopt_nonnull_ref_or_enomem(new (nothrow) Rope(move(pieces), move(chunk)));
+}
+
+ErrorOr<void> Rope::flush_chunk() const
+{
+    if (m_chunk.is_empty())
+        return {};
+    TRY(m_pieces.push(TRY(String::copy(StringView { reinterpret_cast<char const*>(m_chunk.unsafe_data()), m_chunk.size() }))));
+    TRY(m_chunk.resize(0));
+    return {};
+}
+
+ErrorOr<void> Rope::append(String const& string)
+{
+    if (string.is_empty())
+        return {};
+    if (string.length() < shared_piece_threshold) {
+        if (m_chunk.size() + string.length() > chunk_capacity)
+            TRY(flush_chunk());
+        if (m_chunk.capacity() < chunk_capacity)
+            TRY(m_chunk.ensure_capacity(chunk_capacity));
+        TRY(m_chunk.push_values(reinterpret_cast<u8 const*>(string.c_string()), string.length()));
+    } else {
+        TRY(flush_chunk());
+        TRY(m_pieces.push(string));
+    }
+    m_length += string.length();
+    return {};
+}
+
+ErrorOr<void> Rope::append_rope(NonnullRefPtr<Rope> const& other)
+{
+    if (other->is_empty())
+        return {};
+    // Appending a rope to itself reads the pieces it is adding to, so take them first.
+    TRY(other->flush_chunk());
+    auto pieces = other->m_pieces;
+    if (other.ptr() == this)
+        pieces = TRY(Array<String>::create_with({ TRY(to_string()) }));
+    TRY(flush_chunk());
+    TRY(m_pieces.ensure_capacity(m_pieces.size() + pieces.size()));
+    for (size_t i = 0; i < pieces.size(); ++i)
+        TRY(m_pieces.push(pieces[i]));
+    m_length += other->m_length;
+    return {};
+}
+
+ErrorOr<String> Rope::to_string() const
+{
+    if (m_length == 0)
+        return String::empty();
+    TRY(flush_chunk());
+    if (m_pieces.size() == 1)
+        return m_pieces[0];
+
+    char* buffer = nullptr;
+    auto result = TRY(String::create_uninitialized(m_length, buffer));
+    for (size_t i = 0; i < m_pieces.size(); ++i) {
+        auto const& piece = m_pieces[i];
+        __builtin_memcpy(buffer, piece.c_string(), piece.length());
+        buffer += piece.length();
+    }
+    m_pieces = TRY(Array<String>::create_with({ result }));
+    return result;
+}
+
+ErrorOr<void> Rope::write_to(NonnullRefPtr<File> file) const
+{
+    for (size_t i = 0; i < m_pieces.size(); ++i) {
+        auto const& piece = m_pieces[i];
+        TRY(file->write_all({ reinterpret_cast<u8 const*>(piece.c_string()), piece.length() }));
+    }
+    if (!m_chunk.is_empty())
+        TRY(file->write_all({ m_chunk.unsafe_data(), m_chunk.size() }));
+    return {};
+}
+
+void Rope::clear()
+{
+    m_pieces = MUST(Array<String>::create_empty());
+    MUST(m_chunk.resize(0));
+    m_length = 0;
+}
+
+}
@@ -0,0 +1,51 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <Builtins/Array.h>
+#include <IO/File.h>
+#include <Jakt/Error.h>
+#include <Jakt/NonnullRefPtr.h>
+#include <Jakt/RefCounted.h>
+#include <Jakt/String.h>
+
+namespace Jakt {
+
+// Text assembled from appended strings without copying what was appended before. Longer strings are kept as
+// pieces by reference (strings are immutable, so this is just a reference count); short ones are copied into a
+// chunk that becomes a piece once it fills up. The pieces are only joined into one String when to_string() asks
+// for it, and write_to() hands them to the file one by one without joining them at all.
+class Rope final : public RefCounted<Rope> {
+public:
+    static ErrorOr<NonnullRefPtr<Rope>> create();
+
+    ErrorOr<void> append(String const&);
+    // Shares the other rope's pieces, so this copies no text, only the (much shorter) list of pieces.
+    ErrorOr<void> append_rope(NonnullRefPtr<Rope> const&);
+
+    size_t length() const { return m_length; }
+    bool is_empty() const { return m_length == 0; }
+
+    // Joins the pieces, and keeps the result as the only piece so that asking again is free.
+    ErrorOr<String> to_string() const;
+    ErrorOr<void> write_to(NonnullRefPtr<File>) const;
+
+    void clear();
+
+private:
+    Rope(Array<String> pieces, Array<u8> chunk)
+        : m_pieces(move(pieces))
+        , m_chunk(move(chunk))
+    {
+    }
+
+    ErrorOr<void> flush_chunk() const;
+
+    Array<String> mutable m_pieces;
+    Array<u8> mutable m_chunk;
+    size_t m_length { 0 };
+};
+
+}
@@ -0,0 +1,324 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <Jakt/Assertions.h>
+#include <Jakt/Concepts.h>
+#include <Jakt/Error.h>
+#include <Jakt/StdLibExtras.h>
+#include <Jakt/Types.h>
+#include <Jakt/kmalloc.h>
+
+namespace Jakt {
+
+struct DefaultLess {
+    template<typename T>
+    constexpr bool operator()(T const& a, T const& b) const { return a < b; }
+};
+
+namespace Detail {
+
+constexpr size_t insertion_sort_threshold = 24;
+constexpr size_t ninther_threshold = 128;
+// How many elements a partial insertion sort may move before it gives up on a range being nearly sorted.
+constexpr size_t partial_insertion_sort_limit = 8;
+
+template<typename T, typename Less>
+void insertion_sort(T* elements, size_t count, Less const& less)
+{
+    for (size_t i = 1; i < count; ++i) {
+        if (!less(elements[i], elements[i - 1]))
+            continue;
+        T value = move(elements[i]);
+        size_t j = i;
+        do {
+            elements[j] = move(elements[j - 1]);
+            --j;
+        } while (j > 0 && less(value, elements[j - 1]));
+        elements[j] = move(value);
+    }
+}
+
+// Like insertion_sort(), but stops and returns false once it has had to move more than a few elements.
+template<typename T, typename Less>
+bool partial_insertion_sort(T* elements, size_t count, Less const& less)
+{
+    size_t moves = 0;
+    for (size_t i = 1; i < count; ++i) {
+        if (!less(elements[i], elements[i - 1]))
+            continue;
+        T value = move(elements[i]);
+        size_t j = i;
+        do {
+            elements[j] = move(elements[j - 1]);
+            --j;
+        } while (j > 0 && less(value, elements[j - 1]));
+        elements[j] = move(value);
+        moves += i - j;
+        if (moves > partial_insertion_sort_limit)
+            return false;
+    }
+    return true;
+}
+
+template<typename T, typename Less>
+void sift_down(T* elements, size_t root, size_t count, Less const& less)
+{
+    while (true) {
+        size_t child = 2 * root + 1;
+        if (child >= count)
+            return;
+        if (child + 1 < count && less(elements[child], elements[child + 1]))
+            ++child;
+        if (!less(elements[root], elements[child]))
+            return;
+        swap(elements[root], elements[child]);
+        root = child;
+    }
+}
+
+template<typename T, typename Less>
+void heap_sort(T* elements, size_t count, Less const& less)
+{
+    for (size_t i = count / 2; i > 0; --i)
+        sift_down(elements, i - 1, count, less);
+    for (size_t end = count - 1; end > 0; --end) {
+        swap(elements[0], elements[end]);
+        sift_down(elements, 0, end, less);
+    }
+}
+
+template<typename T, typename Less>
+void sort_three(T* elements, size_t a, size_t b, size_t c, Less const& less)
+{
+    if (less(elements[b], elements[a]))
+        swap(elements[a], elements[b]);
+    if (less(elements[c], elements[b])) {
+        swap(elements[b], elements[c]);
+        if (less(elements[b], elements[a]))
+            swap(elements[a], elements[b]);
+    }
+}
+
+// Pattern-defeating introsort: quicksort around a median-of-three (or ninther) pivot, falling back to heap sort
+// when partitions keep coming out lopsided, and to insertion sort for short ranges. A partition that didn't move
+// anything is a hint that the range is already (nearly) sorted, which a bounded insertion sort then confirms in
+// linear time. Elements equal to the pivot are spread over both sides, so runs of duplicates don't go quadratic.
+template<typename T, typename Less>
+void introsort(T* elements, size_t count, size_t depth_limit, Less const& less)
+{
+    while (count > insertion_sort_threshold) {
+        if (depth_limit == 0) {
+            heap_sort(elements, count, less);
+            return;
+        }
+        --depth_limit;
+
+        size_t middle = count / 2;
+        if (count > ninther_threshold) {
+            size_t step = count / 8;
+            sort_three(elements, 0, step, 2 * step, less);
+            sort_three(elements, middle - step, middle, middle + step, less);
+            sort_three(elements, count - 1 - 2 * step, count - 1 - step, count - 1, less);
+            sort_three(elements, step, middle, count - 1 - step, less);
+        } else {
+            sort_three(elements, 0, middle, count - 1, less);
+        }
+        swap(elements[0], elements[middle]);
+
+        size_t left = 0;
+        size_t right = count;
+        bool moved_anything = false;
+        while (true) {
+            do {
+                ++left;
+            } while (left < count && less(elements[left], elements[0]));
+            // Bounded on both sides: a comparator that isn't a strict ordering (like `<=`) can otherwise walk
+            // right past the pivot.
+            do {
+                --right;
+            } while (right > 0 && less(elements[0], elements[right]));
+            if (left >= right)
+                break;
+            swap(elements[left], elements[right]);
+            moved_anything = true;
+        }
+        swap(elements[0], elements[right]);
+
+        auto* upper = elements + right + 1;
+        size_t lower_count = right;
+        size_t upper_count = count - right - 1;
+        if (!moved_anything
+            && partial_insertion_sort(elements, lower_count, less)
+            && partial_insertion_sort(upper, upper_count, less)) {
+            return;
+        }
+
+        // Recurse into the smaller side and loop on the larger one, so the stack stays logarithmic.
+        if (lower_count < upper_count) {
+            introsort(elements, lower_count, depth_limit, less);
+            elements = upper;
+            count = upper_count;
+        } else {
+            introsort(upper, upper_count, depth_limit, less);
+            count = lower_count;
+        }
+    }
+    insertion_sort(elements, count, less);
+}
+
+// Sorts elements[0, count) stably, given uninitialized room for count / 2 elements in `buffer`.
+template<typename T, typename Less>
+void merge_sort(T* elements, size_t count, T* buffer, Less const& less)
+{
+    if (count <= insertion_sort_threshold) {
+        insertion_sort(elements, count, less);
+        return;
+    }
+
+    size_t middle = count / 2;
+    merge_sort(elements, middle, buffer, less);
+    merge_sort(elements + middle, count - middle, buffer, less);
+    if (!less(elements[middle], elements[middle - 1]))
+        return;
+
+    // Move the left half out of the way and merge it with the right half back into place. Taking from the left
+    // half on ties keeps equal elements in their original order.
+    for (size_t i = 0; i < middle; ++i)
+        new (&buffer[i]) T(move(elements[i]));
+    size_t left = 0;
+    size_t right = middle;
+    size_t out = 0;
+    while (left < middle && right < count) {
+        if (less(elements[right], buffer[left]))
+            elements[out++] = move(elements[right++]);
+        else
+            elements[out++] = move(buffer[left++]);
+    }
+    while (left < middle)
+        elements[out++] = move(buffer[left++]);
+    for (size_t i = 0; i < middle; ++i)
+        buffer[i].~T();
+}
+
+template<typename T>
+constexpr bool is_radix_sortable = IsIntegral<T> && !IsSame<RemoveCV<T>, bool>;
+
+// Below this many elements, comparison sorting beats the radix sort's counting passes.
+constexpr size_t radix_sort_threshold = 256;
+
+// Least significant digit first radix sort on bytes, given room for `count` elements in `buffer`. Flipping the
+// sign bit orders signed values correctly as unsigned keys. Passes over a byte that is the same in every element
+// are skipped, so small values in wide types only cost the passes their magnitude needs.
+template<typename T>
+void radix_sort(T* elements, size_t count, T* buffer)
+{
+    using Key = MakeUnsigned<RemoveCV<T>>;
+    constexpr Key sign_flip = IsSigned<T> ? Key(1) << (sizeof(Key) * 8 - 1) : 0;
+
+    size_t counts[sizeof(Key)][256] = {};
+    for (size_t i = 0; i < count; ++i) {
+        Key key = static_cast<Key>(elements[i]) ^ sign_flip;
+        for (size_t digit = 0; digit < sizeof(Key); ++digit)
+            ++counts[digit][(key >> (digit * 8)) & 0xff];
+    }
+
+    T* from = elements;
+    T* to = buffer;
+    for (size_t digit = 0; digit < sizeof(Key); ++digit) {
+        auto& digit_counts = counts[digit];
+        Key first_byte = (static_cast<Key>(from[0]) ^ sign_flip) >> (digit * 8) & 0xff;
+        if (digit_counts[first_byte] == count)
+            continue;
+
+        size_t offsets[256];
+        size_t offset = 0;
+        for (size_t byte = 0; byte < 256; ++byte) {
+            offsets[byte] = offset;
+            offset += digit_counts[byte];
+        }
+        for (size_t i = 0; i < count; ++i) {
+            Key key = static_cast<Key>(from[i]) ^ sign_flip;
+            to[offsets[(key >> (digit * 8)) & 0xff]++] = from[i];
+        }
+        swap(from, to);
+    }
+    if (from != elements)
+        __builtin_memcpy(elements, from, count * sizeof(T));
+}
+
+inline size_t introsort_depth_limit(size_t count)
+{
+    size_t depth = 0;
+    for (; count > 1; count >>= 1)
+        depth += 2;
+    return depth;
+}
+
+}
+
+// Sorts elements[0, count) by `less`, not keeping equal elements in order. Integers compared with the default
+// `<` are radix sorted when there are enough of them (and they aren't sorted already) and memory for a scratch
+// copy.
+template<typename T, typename Less = DefaultLess>
+void sort(T* elements, size_t count, Less const& less = {})
+{
+    if (count < 2)
+        return;
+    if constexpr (Detail::is_radix_sortable<T> && IsSame<Less, DefaultLess>) {
+        if (count >= Detail::radix_sort_threshold) {
+            // Radix sorting doesn't get any faster on sorted input, so check for that first.
+            size_t sorted_prefix = 1;
+            while (sorted_prefix < count && !(elements[sorted_prefix] < elements[sorted_prefix - 1]))
+                ++sorted_prefix;
+            if (sorted_prefix == count)
+                return;
+            if (auto* buffer = static_cast<T*>(kmalloc_array(count, sizeof(T)))) {
+                Detail::radix_sort(elements, count, buffer);
+                kfree_sized(buffer, count * sizeof(T));
+                return;
+            }
+        }
+    }
+    Detail::introsort(elements, count, Detail::introsort_depth_limit(count), less);
+}
+
+// Sorts elements[0, count) by `less`, keeping equal elements in their original order. Fails with ENOMEM if there
+// is no memory for the scratch space of count / 2 elements.
+template<typename T, typename Less = DefaultLess>
+ErrorOr<void> stable_sort(T* elements, size_t count, Less const& less = {})
+{
+    if (count < 2)
+        return {};
+    if (count <= Detail::insertion_sort_threshold) {
+        Detail::insertion_sort(elements, count, less);
+        return {};
+    }
+    auto* buffer = static_cast<T*>(kmalloc_array(count / 2, sizeof(T)));
+    if (!buffer)
+        return Error::from_errno(ENOMEM);
+    Detail::merge_sort(elements, count, buffer, less);
+    kfree_sized(buffer, count / 2 * sizeof(T));
+    return {};
+}
+
+// The index of the first of elements[0, count) that isn't less than `value`, given that they are sorted.
+template<typename T, typename Less = DefaultLess>
+size_t lower_bound(T const* elements, size_t count, T const& value, Less const& less = {})
+{
+    size_t first = 0;
+    while (count > 0) {
+        size_t half = count / 2;
+        if (less(elements[first + half], value)) {
+            first += half + 1;
+            count -= half + 1;
+        } else {
+            count = half;
+        }
+    }
+    return first;
+}
+
+}
@@ -84,15 +84,17 @@ ErrorOr<Array<String>> String::split_limit(char separator, size_t limit, bool ke
     if (is_empty())
         return v;
 
+    auto const* characters = c_string();
     size_t substart = 0;
-    for (size_t i = 0; i < length() && (v.size() + 1) != limit; ++i) {
-        char ch = c_string()[i];
-        if (ch == separator) {
-            size_t sublen = i - substart;
-            if (sublen != 0 || keep_empty)
-                TRY(v.push(TRY(substring(substart, sublen))));
-            substart = i + 1;
-        }
+    while ((v.size() + 1) != limit) {
+        auto const* match = static_cast<char const*>(__builtin_memchr(characters + substart, separator, length() - substart));
+        if (!match)
+            break;
+        size_t i = match - characters;
+        size_t sublen = i - substart;
+        if (sublen != 0 || keep_empty)
+            TRY(v.push(TRY(substring(substart, sublen))));
+        substart = i + 1;
     }
     size_t taillen = length() - substart;
     if (taillen != 0 || keep_empty)
@@ -147,6 +149,11 @@ bool String::ends_with(char ch) const
     return c_string()[length() - 1] == ch;
 }
 
+ErrorOr<String> String::create_uninitialized(size_t length, char*& buffer)
+{
+    return String { TRY(StringStorage::create_uninitialized(length, buffer)) };
+}
+
 ErrorOr<String> String::repeated(char ch, size_t count)
 {
     if (!count)
@@ -197,11 +204,6 @@ bool String::operator==(char const* c_string) const
     return view() == c_string;
 }
 
-void StringStorage::operator delete(void* ptr)
-{
-    free(ptr);
-}
-
 static StringStorage* s_the_empty_string_storage = nullptr;
 
 StringStorage& StringStorage::the_empty_string()
@@ -227,10 +229,17 @@ constexpr size_t allocation_size_for_string_storage(size_t length)
     return sizeof(StringStorage) + (sizeof(char) * length) + sizeof(char);
 }
 
+void StringStorage::operator delete(StringStorage* ptr, std::destroying_delete_t)
+{
+    auto size = allocation_size_for_string_storage(ptr->length());
+    ptr->~StringStorage();
+    kfree_slab(ptr, size);
+}
+
 ErrorOr<NonnullRefPtr<StringStorage>> StringStorage::create_uninitialized(size_t length, char*& buffer)
 {
     VERIFY(length);
-    void* slot = malloc(allocation_size_for_string_storage(length));
+    void* slot = kmalloc_slab(allocation_size_for_string_storage(length));
     if (!slot) {
         return Error::from_errno(ENOMEM);
     }
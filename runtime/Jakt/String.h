@@ -24,7 +24,8 @@ public:
     static ErrorOr<NonnullRefPtr<StringStorage>> create_uninitialized(size_t length, char*& buffer);
     static ErrorOr<NonnullRefPtr<StringStorage>> create(char const* c_string, size_t length);
 
-    void operator delete(void* ptr);
+    // Gives the storage back to kfree_slab(), which needs the size it was allocated with.
+    void operator delete(StringStorage* ptr, std::destroying_delete_t);
 
     static StringStorage& the_empty_string();
 
@@ -107,6 +108,8 @@ public:
     [[nodiscard]] static String empty() { return String { StringStorage::the_empty_string() }; }
     static ErrorOr<String> from_utf8(StringView);
     static ErrorOr<String> copy(StringView);
+    // A string of `length` (non-zero) bytes for the caller to fill in through `buffer` before anyone reads it.
+    static ErrorOr<String> create_uninitialized(size_t length, char*& buffer);
 
     [[nodiscard]] static ErrorOr<String> vformatted(StringView fmtstr, TypeErasedFormatParams&);
 
@@ -188,6 +191,9 @@ public:
         return m_storage->hash();
     }
 
+    static void make_optional_niche(String* storage) { NonnullRefPtr<StringStorage>::make_optional_niche(&storage->m_storage); }
+    static bool is_optional_niche(String const* storage) { return NonnullRefPtr<StringStorage>::is_optional_niche(&storage->m_storage); }
+
     template<typename T>
     [[nodiscard]] static ErrorOr<String> number(T value) requires IsArithmetic<T>
     {
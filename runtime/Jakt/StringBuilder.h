@@ -280,4 +280,28 @@ struct Formatter<Jakt::Tuple<Ts...>> : Formatter<StringView> {
     }
 };
 
+#ifndef KERNEL
+template<typename... Pieces>
+void out_pieces(FILE* file, bool newline, Pieces const&... pieces)
+{
+    auto builder = MUST(StringBuilder::create());
+    FormatBuilder format_builder { builder };
+    MUST(format_pieces(format_builder, pieces...));
+
+    if (newline)
+        MUST(builder.append('\n'));
+
+    out_string(file, builder.string_view());
+}
+#endif
+
+template<typename... Pieces>
+ErrorOr<String> formatted_pieces(Pieces const&... pieces)
+{
+    auto builder = TRY(StringBuilder::create());
+    FormatBuilder format_builder { builder };
+    TRY(format_pieces(format_builder, pieces...));
+    return builder.to_string();
+}
+
 }
@@ -296,11 +296,11 @@ Optional<size_t> find(StringView haystack, char needle, size_t start)
 {
     if (start >= haystack.length())
         return {};
-    for (size_t i = start; i < haystack.length(); ++i) {
-        if (haystack[i] == needle)
-            return i;
-    }
-    return {};
+    auto const* characters = haystack.characters_without_null_termination();
+    auto const* match = static_cast<char const*>(__builtin_memchr(characters + start, needle, haystack.length() - start));
+    if (!match)
+        return {};
+    return static_cast<size_t>(match - characters);
 }
 
 Optional<size_t> find(StringView haystack, StringView needle, size_t start)
@@ -361,40 +361,44 @@ ErrorOr<String> replace(StringView str, StringView needle, StringView replacemen
     if (str.is_empty())
         return String::copy(str);
 
-    auto positions = TRY(JaktInternal::Array<size_t>::create_empty());
-    if (all_occurrences) {
-        positions = TRY(str.find_all(needle));
-        if (!positions.size())
-            return String::copy(str);
-    } else {
-        auto pos = str.find(needle);
-        if (!pos.has_value())
-            return String::copy(str);
-        TRY(positions.push(pos.value()));
-    }
-
-    auto replaced_string = TRY(StringBuilder::create());
+    // Matches are replaced left to right in a single pass, and the search resumes after each one, so overlapping
+    // matches ("aa" in "aaa") only replace the first. An empty needle matches between every two characters.
+    Optional<StringBuilder> replaced_string;
     size_t last_position = 0;
-    for (size_t i = 0; i < positions.size(); ++i) {
-        auto& position = positions[i];
-        TRY(replaced_string.append(str.substring_view(last_position, position - last_position)));
-        TRY(replaced_string.append(replacement));
-        last_position = position + needle.length();
+    size_t search_start = 0;
+    while (search_start <= str.length()) {
+        auto position = find(str, needle, search_start);
+        if (!position.has_value())
+            break;
+        if (!replaced_string.has_value())
+            replaced_string = TRY(StringBuilder::create());
+        TRY(replaced_string->append(str.substring_view(last_position, *position - last_position)));
+        TRY(replaced_string->append(replacement));
+        last_position = *position + needle.length();
+        search_start = *position + max(needle.length(), static_cast<size_t>(1));
+        if (!all_occurrences)
+            break;
     }
-    TRY(replaced_string.append(str.substring_view(last_position, str.length() - last_position)));
-    return replaced_string.to_string();
+    if (!replaced_string.has_value())
+        return String::copy(str);
+    TRY(replaced_string->append(str.substring_view(last_position, str.length() - last_position)));
+    return replaced_string->to_string();
 }
 
-// TODO: Benchmark against KMP (Jakt/MemMem.h) and switch over if it's faster for short strings too
+// Counts overlapping occurrences, so "aa" occurs twice in "aaa".
 size_t count(StringView str, StringView needle)
 {
     if (needle.is_empty())
         return str.length();
 
     size_t count = 0;
-    for (size_t i = 0; i < str.length() - needle.length() + 1; ++i) {
-        if (str.substring_view(i).starts_with(needle))
-            count++;
+    size_t start = 0;
+    while (true) {
+        auto position = find(str, needle, start);
+        if (!position.has_value())
+            break;
+        ++count;
+        start = *position + 1;
     }
     return count;
 }
@@ -47,11 +47,9 @@ bool StringView::ends_with(StringView str, CaseSensitivity case_sensitivity) con
 
 bool StringView::contains(char needle) const
 {
-    for (char current : *this) {
-        if (current == needle)
-            return true;
-    }
-    return false;
+    if (is_empty())
+        return false;
+    return __builtin_memchr(characters_without_null_termination(), needle, length()) != nullptr;
 }
 
 bool StringView::contains(StringView needle, CaseSensitivity case_sensitivity) const
@@ -0,0 +1,165 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <Jakt/Assertions.h>
+#include <Jakt/StdLibExtras.h>
+#include <Jakt/Types.h>
+
+namespace Jakt {
+
+// The storage of sum enums: one value of one of Ts, which must be distinct, plus the index of its type in the
+// smallest integer that can hold it. Unlike Variant, every operation is a single fold over Ts rather than a chain of
+// recursive templates, which keeps enums with many variants cheap to instantiate; the compiler turns the folds into
+// switches on the index.
+template<typename... Ts>
+class TaggedUnion {
+public:
+    using IndexType = Conditional<sizeof...(Ts) < 255, u8, size_t>;
+
+    // Never the index of a value; Optional uses it to mean "no value".
+    static constexpr IndexType niche_index = sizeof...(Ts);
+
+    template<typename T>
+    static constexpr IndexType index_of()
+    {
+        IndexType index = 0;
+        (void)((IsSame<T, Ts> || (++index, false)) || ...);
+        return index;
+    }
+
+    template<typename T>
+    static constexpr bool can_contain() { return index_of<T>() != niche_index; }
+
+    template<typename T, typename StrippedT = RemoveCVReference<T>>
+    requires(can_contain<StrippedT>()) ALWAYS_INLINE TaggedUnion(T&& value)
+        : m_index(index_of<StrippedT>())
+    {
+        new (m_data) StrippedT(forward<T>(value));
+    }
+
+#ifdef AK_HAS_CONDITIONALLY_TRIVIAL
+    TaggedUnion(TaggedUnion const&) requires((IsTriviallyCopyConstructible<Ts> && ...)) = default;
+    TaggedUnion(TaggedUnion&&) requires((IsTriviallyMoveConstructible<Ts> && ...)) = default;
+    ~TaggedUnion() requires((IsTriviallyDestructible<Ts> && ...)) = default;
+    TaggedUnion& operator=(TaggedUnion const&) requires((IsTriviallyCopyConstructible<Ts> && ...) && (IsTriviallyDestructible<Ts> && ...)) = default;
+    TaggedUnion& operator=(TaggedUnion&&) requires((IsTriviallyMoveConstructible<Ts> && ...) && (IsTriviallyDestructible<Ts> && ...)) = default;
+#endif
+
+    ALWAYS_INLINE TaggedUnion(TaggedUnion const& other)
+#ifdef AK_HAS_CONDITIONALLY_TRIVIAL
+        requires(!(IsTriviallyCopyConstructible<Ts> && ...))
+#endif
+        : m_index(other.m_index)
+    {
+        copy_from(other);
+    }
+
+    // Like Variant, a moved-from TaggedUnion keeps holding the moved-from alternative.
+    ALWAYS_INLINE TaggedUnion(TaggedUnion&& other)
+#ifdef AK_HAS_CONDITIONALLY_TRIVIAL
+        requires(!(IsTriviallyMoveConstructible<Ts> && ...))
+#endif
+        : m_index(other.m_index)
+    {
+        move_from(other);
+    }
+
+    ALWAYS_INLINE ~TaggedUnion()
+#ifdef AK_HAS_CONDITIONALLY_TRIVIAL
+        requires(!(IsTriviallyDestructible<Ts> && ...))
+#endif
+    {
+        destroy();
+    }
+
+    ALWAYS_INLINE TaggedUnion& operator=(TaggedUnion const& other)
+#ifdef AK_HAS_CONDITIONALLY_TRIVIAL
+        requires(!(IsTriviallyCopyConstructible<Ts> && ...) || !(IsTriviallyDestructible<Ts> && ...))
+#endif
+    {
+        if (this != &other) {
+            destroy();
+            m_index = other.m_index;
+            copy_from(other);
+        }
+        return *this;
+    }
+
+    ALWAYS_INLINE TaggedUnion& operator=(TaggedUnion&& other)
+#ifdef AK_HAS_CONDITIONALLY_TRIVIAL
+        requires(!(IsTriviallyMoveConstructible<Ts> && ...) || !(IsTriviallyDestructible<Ts> && ...))
+#endif
+    {
+        if (this != &other) {
+            destroy();
+            m_index = other.m_index;
+            move_from(other);
+        }
+        return *this;
+    }
+
+    [[nodiscard]] ALWAYS_INLINE IndexType index() const { return m_index; }
+
+    template<typename T>
+    [[nodiscard]] ALWAYS_INLINE bool has() const requires(can_contain<T>())
+    {
+        return m_index == index_of<T>();
+    }
+
+    template<typename T>
+    [[nodiscard]] ALWAYS_INLINE T& get() requires(can_contain<T>())
+    {
+        VERIFY(has<T>());
+        return *__builtin_launder(reinterpret_cast<T*>(m_data));
+    }
+
+    template<typename T>
+    [[nodiscard]] ALWAYS_INLINE T const& get() const requires(can_contain<T>())
+    {
+        VERIFY(has<T>());
+        return *__builtin_launder(reinterpret_cast<T const*>(m_data));
+    }
+
+    // For OptionalNiche, which sum enums inherit; `storage` is uninitialized, or holds the niche.
+    static void make_optional_niche(TaggedUnion* storage) { storage->m_index = niche_index; }
+    static bool is_optional_niche(TaggedUnion const* storage) { return storage->m_index == niche_index; }
+
+private:
+    // Calls `callback.template operator()<T>()` for the T at `index`, if there is one.
+    template<typename Callback>
+    ALWAYS_INLINE static void with_type_at(IndexType index, Callback callback)
+    {
+        IndexType current = 0;
+        (void)(((current++ == index) && (callback.template operator()<Ts>(), true)) || ...);
+    }
+
+    ALWAYS_INLINE void copy_from(TaggedUnion const& other)
+    {
+        with_type_at(m_index, [&]<typename T>() { new (m_data) T(*__builtin_launder(reinterpret_cast<T const*>(other.m_data))); });
+    }
+
+    ALWAYS_INLINE void move_from(TaggedUnion& other)
+    {
+        with_type_at(m_index, [&]<typename T>() { new (m_data) T(move(*__builtin_launder(reinterpret_cast<T*>(other.m_data)))); });
+    }
+
+    ALWAYS_INLINE void destroy()
+    {
+        with_type_at(m_index, [&]<typename T>() { __builtin_launder(reinterpret_cast<T*>(m_data))->~T(); });
+    }
+
+    static constexpr size_t data_size()
+    {
+        size_t size = 0;
+        ((size = sizeof(Ts) > size ? sizeof(Ts) : size), ...);
+        return size;
+    }
+
+    alignas(Ts...) u8 m_data[data_size()];
+    IndexType m_index;
+};
+
+}
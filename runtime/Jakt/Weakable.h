@@ -31,7 +31,7 @@ class WeakLink : public RefCounted<WeakLink> {
 public:
     template<typename T>
     RefPtr<T> strong_ref() const
-        requires(IsBaseOf<RefCountedBase, T>)
+        requires(requires(T const& object) { object.try_ref(); })
     {
         RefPtr<T> ref;
 
@@ -60,3 +60,352 @@ void operator delete[](void* ptr, size_t) noexcept
 }
 
 #endif
+
+#if !defined(KERNEL)
+
+#    include <Jakt/Arena.h>
+#    include <Jakt/Atomic.h>
+#    include <Jakt/kmalloc.h>
+#    include <stdio.h>
+#    include <string.h>
+
+namespace Jakt {
+
+namespace {
+
+constexpr size_t slab_granularity = 16;
+constexpr size_t slab_max_size = 256;
+constexpr size_t slab_class_count = slab_max_size / slab_granularity;
+constexpr size_t slab_chunk_size = 64 * KiB;
+
+// Past this many free blocks of one class, a thread hands them to the depot, so that blocks one thread keeps
+// freeing and another keeps allocating are reused rather than piling up.
+constexpr size_t slab_flush_threshold = 4096;
+
+size_t size_class_of(size_t size) { return size ? (size - 1) / slab_granularity : 0; }
+size_t block_size_of(size_t size_class) { return (size_class + 1) * slab_granularity; }
+
+struct FreeBlock {
+    FreeBlock* next;
+};
+
+struct SlabStats {
+    u64 allocations[slab_class_count];
+    u64 frees[slab_class_count];
+    u64 chunks[slab_class_count];
+    u64 large_allocations;
+    u64 large_frees;
+    u64 arena_allocations;
+    u64 arena_bytes;
+
+    void add(SlabStats const& other)
+    {
+        for (size_t i = 0; i < slab_class_count; ++i) {
+            allocations[i] += other.allocations[i];
+            frees[i] += other.frees[i];
+            chunks[i] += other.chunks[i];
+        }
+        large_allocations += other.large_allocations;
+        large_frees += other.large_frees;
+        arena_allocations += other.arena_allocations;
+        arena_bytes += other.arena_bytes;
+    }
+};
+
+// A thread's free lists, plus the not yet handed out tail of the chunk each class last got from malloc.
+struct SlabCache {
+    FreeBlock* free_lists[slab_class_count];
+    size_t free_counts[slab_class_count];
+    u8* carve_next[slab_class_count];
+    u8* carve_end[slab_class_count];
+    SlabStats stats;
+    SlabCache* previous_live;
+    SlabCache* next_live;
+};
+
+class SpinLock {
+public:
+    void lock()
+    {
+        while (atomic_exchange(&m_locked, true, memory_order_acquire)) {
+            while (atomic_load(&m_locked, memory_order_relaxed))
+                ;
+        }
+    }
+    void unlock() { atomic_store(&m_locked, false, memory_order_release); }
+
+private:
+    bool m_locked { false };
+};
+
+enum SlabMode : int {
+    SlabModeUndecided = 0,
+    SlabModeSlab,
+    SlabModeMalloc,
+};
+
+// Everything below is guarded by s_lock, except s_mode.
+SpinLock s_lock;
+int s_mode { SlabModeUndecided };
+bool s_report_registered { false };
+// Blocks handed over by threads that exited, or that freed more than they allocated.
+FreeBlock* s_depot[slab_class_count];
+// Serves the allocations made by a thread after its own cache is gone, in its thread-exit destructors.
+SlabCache s_orphan_cache;
+SlabCache* s_live_caches { nullptr };
+SlabStats s_retired_stats;
+
+void report_stats();
+
+bool slab_enabled()
+{
+    auto mode = atomic_load(&s_mode, memory_order_relaxed);
+    if (mode != SlabModeUndecided)
+        return mode == SlabModeSlab;
+
+    auto const* slab_setting = getenv("JAKT_SLAB_ALLOCATOR");
+    mode = slab_setting && strcmp(slab_setting, "0") == 0 ? SlabModeMalloc : SlabModeSlab;
+
+    auto const* stats_setting = getenv("JAKT_ALLOC_STATS");
+    if (mode == SlabModeSlab && stats_setting && *stats_setting && strcmp(stats_setting, "0") != 0) {
+        s_lock.lock();
+        if (!s_report_registered) {
+            s_report_registered = true;
+            atexit(report_stats);
+        }
+        s_lock.unlock();
+    }
+
+    atomic_store(&s_mode, mode, memory_order_relaxed);
+    return mode == SlabModeSlab;
+}
+
+void push_to_depot(size_t size_class, FreeBlock* first, FreeBlock* last)
+{
+    last->next = s_depot[size_class];
+    s_depot[size_class] = first;
+}
+
+void* carve(SlabCache& cache, size_t size_class)
+{
+    auto block_size = block_size_of(size_class);
+    if (static_cast<size_t>(cache.carve_end[size_class] - cache.carve_next[size_class]) < block_size) {
+        auto* chunk = static_cast<u8*>(malloc(slab_chunk_size));
+        if (!chunk)
+            return nullptr;
+        cache.carve_next[size_class] = chunk;
+        cache.carve_end[size_class] = chunk + slab_chunk_size;
+        ++cache.stats.chunks[size_class];
+    }
+    auto* block = cache.carve_next[size_class];
+    cache.carve_next[size_class] += block_size;
+    return block;
+}
+
+void retire_cache(SlabCache* cache)
+{
+    s_lock.lock();
+    for (size_t size_class = 0; size_class < slab_class_count; ++size_class) {
+        // Hand the rest of the current chunk over too, rather than leaking it with the thread.
+        auto block_size = block_size_of(size_class);
+        while (static_cast<size_t>(cache->carve_end[size_class] - cache->carve_next[size_class]) >= block_size) {
+            auto* block = reinterpret_cast<FreeBlock*>(cache->carve_next[size_class]);
+            cache->carve_next[size_class] += block_size;
+            push_to_depot(size_class, block, block);
+        }
+
+        auto* first = cache->free_lists[size_class];
+        if (!first)
+            continue;
+        auto* last = first;
+        while (last->next)
+            last = last->next;
+        push_to_depot(size_class, first, last);
+    }
+
+    s_retired_stats.add(cache->stats);
+    if (cache->previous_live)
+        cache->previous_live->next_live = cache->next_live;
+    else
+        s_live_caches = cache->next_live;
+    if (cache->next_live)
+        cache->next_live->previous_live = cache->previous_live;
+    s_lock.unlock();
+
+    free(cache);
+}
+
+thread_local SlabCache* t_cache { nullptr };
+thread_local bool t_cache_retired { false };
+
+struct CacheRetirer {
+    bool armed { false };
+    ~CacheRetirer()
+    {
+        if (t_cache)
+            retire_cache(t_cache);
+        t_cache = nullptr;
+        t_cache_retired = true;
+    }
+};
+thread_local CacheRetirer t_retirer;
+
+// Null once the thread's exit destructors have given its cache back.
+SlabCache* thread_cache()
+{
+    if (t_cache || t_cache_retired)
+        return t_cache;
+
+    auto* cache = static_cast<SlabCache*>(calloc(1, sizeof(SlabCache)));
+    VERIFY(cache);
+    s_lock.lock();
+    cache->next_live = s_live_caches;
+    if (s_live_caches)
+        s_live_caches->previous_live = cache;
+    s_live_caches = cache;
+    s_lock.unlock();
+
+    t_retirer.armed = true;
+    t_cache = cache;
+    return cache;
+}
+
+void report_stats()
+{
+    s_lock.lock();
+    SlabStats total = s_retired_stats;
+    total.add(s_orphan_cache.stats);
+    for (auto* cache = s_live_caches; cache; cache = cache->next_live)
+        total.add(cache->stats);
+    s_lock.unlock();
+
+    fflush(stdout);
+    fprintf(stderr, "jakt slab allocator statistics:\n");
+    fprintf(stderr, "%8s %14s %14s %12s %8s\n", "size", "allocations", "frees", "live", "chunks");
+    for (size_t size_class = 0; size_class < slab_class_count; ++size_class) {
+        if (!total.allocations[size_class])
+            continue;
+        fprintf(stderr, "%8zu %14llu %14llu %12lld %8llu\n", block_size_of(size_class),
+            static_cast<unsigned long long>(total.allocations[size_class]),
+            static_cast<unsigned long long>(total.frees[size_class]),
+            static_cast<long long>(total.allocations[size_class] - total.frees[size_class]),
+            static_cast<unsigned long long>(total.chunks[size_class]));
+    }
+    fprintf(stderr, "%8s %14llu %14llu %12lld %8s\n", "> 256",
+        static_cast<unsigned long long>(total.large_allocations),
+        static_cast<unsigned long long>(total.large_frees),
+        static_cast<long long>(total.large_allocations - total.large_frees), "-");
+    if (total.arena_allocations) {
+        fprintf(stderr, "arena scopes: %llu allocations, %llu bytes\n",
+            static_cast<unsigned long long>(total.arena_allocations),
+            static_cast<unsigned long long>(total.arena_bytes));
+    }
+}
+
+}
+
+void* kmalloc_slab(size_t size)
+{
+    if (!slab_enabled())
+        return malloc(size);
+
+    auto* cache = thread_cache();
+    if (auto* arena = ArenaScope::current()) {
+        if (cache) {
+            ++cache->stats.arena_allocations;
+            cache->stats.arena_bytes += size;
+        }
+        return arena->allocate(size);
+    }
+    if (size > slab_max_size) {
+        if (cache)
+            ++cache->stats.large_allocations;
+        return malloc(size);
+    }
+
+    auto size_class = size_class_of(size);
+    if (!cache) {
+        s_lock.lock();
+        void* block = s_depot[size_class];
+        if (block)
+            s_depot[size_class] = s_depot[size_class]->next;
+        else
+            block = carve(s_orphan_cache, size_class);
+        if (block)
+            ++s_orphan_cache.stats.allocations[size_class];
+        s_lock.unlock();
+        return block;
+    }
+
+    auto*& free_list = cache->free_lists[size_class];
+    if (!free_list && atomic_load(&s_depot[size_class], memory_order_relaxed)) {
+        s_lock.lock();
+        free_list = s_depot[size_class];
+        s_depot[size_class] = nullptr;
+        s_lock.unlock();
+    }
+
+    void* block = free_list;
+    if (block) {
+        free_list = free_list->next;
+        if (cache->free_counts[size_class])
+            --cache->free_counts[size_class];
+    } else {
+        block = carve(*cache, size_class);
+        if (!block)
+            return nullptr;
+    }
+    ++cache->stats.allocations[size_class];
+    return block;
+}
+
+void kfree_slab(void* ptr, size_t size)
+{
+    if (!ptr)
+        return;
+    if (!slab_enabled()) {
+        free(ptr);
+        return;
+    }
+
+    // Arena blocks go away with their scope.
+    if (auto* arena = ArenaScope::current(); arena && arena->contains(ptr))
+        return;
+
+    auto* cache = thread_cache();
+    if (size > slab_max_size) {
+        if (cache)
+            ++cache->stats.large_frees;
+        free(ptr);
+        return;
+    }
+
+    auto size_class = size_class_of(size);
+    auto* block = static_cast<FreeBlock*>(ptr);
+    if (!cache) {
+        s_lock.lock();
+        push_to_depot(size_class, block, block);
+        ++s_orphan_cache.stats.frees[size_class];
+        s_lock.unlock();
+        return;
+    }
+
+    block->next = cache->free_lists[size_class];
+    cache->free_lists[size_class] = block;
+    ++cache->stats.frees[size_class];
+    if (++cache->free_counts[size_class] < slab_flush_threshold)
+        return;
+
+    auto* last = block;
+    while (last->next)
+        last = last->next;
+    s_lock.lock();
+    push_to_depot(size_class, block, last);
+    s_lock.unlock();
+    cache->free_lists[size_class] = nullptr;
+    cache->free_counts[size_class] = 0;
+}
+
+}
+
+#endif
@@ -2,6 +2,8 @@
 
 int main(int argc, char** argv)
 {
+    Jakt::set_up_output_buffering();
+
     auto args = MUST(Jakt::Array<Jakt::String>::create_empty());
     for (int i = 0; i < argc; ++i) {
         MUST(args.push(MUST(Jakt::String::copy(Jakt::StringView(argv[i])))));
@@ -0,0 +1,124 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Jakt/ScopeGuard.h>
+#include <Jakt/kmalloc.h>
+#include <Process/Process.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/wait.h>
+
+extern char** environ;
+
+namespace JaktInternal {
+
+static ExitStatus exit_status_from_wait_status(i32 pid, int status)
+{
+    if (WIFSIGNALED(status))
+        return ExitStatus { pid, 128 + WTERMSIG(status), WTERMSIG(status) };
+    return ExitStatus { pid, WEXITSTATUS(status), 0 };
+}
+
+ErrorOr<i32> spawn_process(Array<String> args, Optional<String> stdin_path, Optional<String> stdout_path, Optional<String> stderr_path)
+{
+    if (args.is_empty())
+        return Error::from_errno(EINVAL);
+
+    // Jakt strings are NUL-terminated already, so argv can point straight at them.
+    auto** argv = static_cast<char**>(kmalloc_array(args.size() + 1, sizeof(char*)));
+    if (!argv)
+        return Error::from_errno(ENOMEM);
+    ScopeGuard free_argv = [&] { kfree_sized(argv, (args.size() + 1) * sizeof(char*)); };
+    for (size_t i = 0; i < args.size(); ++i)
+        argv[i] = const_cast<char*>(args[i].c_string());
+    argv[args.size()] = nullptr;
+
+    posix_spawn_file_actions_t file_actions;
+    if (int rc = posix_spawn_file_actions_init(&file_actions); rc != 0)
+        return Error::from_errno(rc);
+    ScopeGuard destroy_file_actions = [&] { posix_spawn_file_actions_destroy(&file_actions); };
+
+    struct Redirection {
+        Optional<String> const& path;
+        int fd;
+        int flags;
+    };
+    for (auto const& redirection : {
+             Redirection { stdin_path, STDIN_FILENO, O_RDONLY },
+             Redirection { stdout_path, STDOUT_FILENO, O_WRONLY | O_CREAT | O_TRUNC },
+             Redirection { stderr_path, STDERR_FILENO, O_WRONLY | O_CREAT | O_TRUNC },
+         }) {
+        if (!redirection.path.has_value())
+            continue;
+        if (int rc = posix_spawn_file_actions_addopen(&file_actions, redirection.fd, redirection.path->c_string(), redirection.flags, 0644); rc != 0)
+            return Error::from_errno(rc);
+    }
+
+    posix_spawnattr_t attributes;
+    if (int rc = posix_spawnattr_init(&attributes); rc != 0)
+        return Error::from_errno(rc);
+    ScopeGuard destroy_attributes = [&] { posix_spawnattr_destroy(&attributes); };
+
+    sigset_t empty_mask;
+    sigemptyset(&empty_mask);
+    sigset_t default_signals;
+    sigemptyset(&default_signals);
+    sigaddset(&default_signals, SIGPIPE);
+    sigaddset(&default_signals, SIGCHLD);
+    short flags = POSIX_SPAWN_SETSIGMASK | POSIX_SPAWN_SETSIGDEF;
+#ifdef POSIX_SPAWN_USEVFORK
+    // Older glibc versions only avoid copying the parent's memory when asked to.
+    flags |= POSIX_SPAWN_USEVFORK;
+#endif
+    if (int rc = posix_spawnattr_setsigmask(&attributes, &empty_mask); rc != 0)
+        return Error::from_errno(rc);
+    if (int rc = posix_spawnattr_setsigdefault(&attributes, &default_signals); rc != 0)
+        return Error::from_errno(rc);
+    if (int rc = posix_spawnattr_setflags(&attributes, flags); rc != 0)
+        return Error::from_errno(rc);
+
+    pid_t pid = 0;
+    // Unlike fork() + exec(), this reports a program that couldn't be started as an error here, rather than as a
+    // child that exits with 127.
+    if (int rc = posix_spawnp(&pid, argv[0], &file_actions, &attributes, argv, environ); rc != 0)
+        return Error::from_errno(rc);
+    return pid;
+}
+
+ErrorOr<Optional<ExitStatus>> poll_for_exit(i32 pid)
+{
+    int status = 0;
+    pid_t result;
+    do {
+        result = waitpid(pid, &status, WNOHANG);
+    } while (result == -1 && errno == EINTR);
+    if (result == -1)
+        return Error::from_errno(errno);
+    if (result == 0)
+        return Optional<ExitStatus> {};
+    return Optional<ExitStatus> { exit_status_from_wait_status(result, status) };
+}
+
+ErrorOr<ExitStatus> wait_for_exit(i32 pid)
+{
+    int status = 0;
+    pid_t result;
+    do {
+        result = waitpid(pid, &status, 0);
+    } while (result == -1 && errno == EINTR);
+    if (result == -1)
+        return Error::from_errno(errno);
+    return exit_status_from_wait_status(result, status);
+}
+
+ErrorOr<void> kill_process(i32 pid, i32 signal)
+{
+    if (kill(pid, signal) == -1)
+        return Error::from_errno(errno);
+    return {};
+}
+
+}
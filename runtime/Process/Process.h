@@ -0,0 +1,59 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <Builtins/Array.h>
+#include <Jakt/Error.h>
+#include <Jakt/Optional.h>
+#include <Jakt/String.h>
+
+namespace JaktInternal {
+
+// How a child process ended.
+class ExitStatus {
+public:
+    constexpr ExitStatus(i32 pid, i32 exit_code, i32 signal)
+        : m_pid(pid)
+        , m_exit_code(exit_code)
+        , m_signal(signal)
+    {
+    }
+
+    i32 pid() const { return m_pid; }
+    // For a process killed by a signal, 128 plus the signal number, the way shells report it.
+    i32 exit_code() const { return m_exit_code; }
+    // The signal that killed the process, or 0 if it exited.
+    i32 signal() const { return m_signal; }
+
+private:
+    i32 m_pid { 0 };
+    i32 m_exit_code { 0 };
+    i32 m_signal { 0 };
+};
+
+// Starts args[0] (looked up in PATH) with `args`, and returns its pid. The child is started with posix_spawnp(),
+// which doesn't copy the parent's page tables the way fork() does, so it costs the same however large the parent
+// is. The child gets an empty signal mask and default handling of SIGPIPE and SIGCHLD, whatever the parent set up
+// for them, and each given path replaces the corresponding standard stream (stdin opened for reading, stdout and
+// stderr truncated or created for writing).
+ErrorOr<i32> spawn_process(Array<String> args, Optional<String> stdin_path, Optional<String> stdout_path, Optional<String> stderr_path);
+
+// Reaps the child `pid` (or any child, for -1) if it has ended, without blocking.
+ErrorOr<Optional<ExitStatus>> poll_for_exit(i32 pid);
+
+// Blocks until the child `pid` (or any child, for -1) ends, and reaps it. Fails with ECHILD if there is none.
+ErrorOr<ExitStatus> wait_for_exit(i32 pid);
+
+ErrorOr<void> kill_process(i32 pid, i32 signal);
+
+}
+
+namespace Jakt {
+using JaktInternal::ExitStatus;
+using JaktInternal::kill_process;
+using JaktInternal::poll_for_exit;
+using JaktInternal::spawn_process;
+using JaktInternal::wait_for_exit;
+}
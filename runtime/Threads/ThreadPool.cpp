@@ -0,0 +1,450 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Builtins/Array.h>
+#include <Jakt/Atomic.h>
+#include <Jakt/RefPtr.h>
+#include <Jakt/kmalloc.h>
+#include <Threads/ThreadPool.h>
+#include <errno.h>
+#include <pthread.h>
+#include <unistd.h>
+
+namespace JaktInternal {
+
+namespace {
+
+// One thread's queue of tasks that haven't started yet. The owner pushes and pops at the back, running the newest
+// task first while its data is still in cache; other threads steal from the front, taking the oldest task, which
+// is usually the one that will spawn the most further work.
+class WorkQueue {
+    AK_MAKE_NONCOPYABLE(WorkQueue);
+    AK_MAKE_NONMOVABLE(WorkQueue);
+
+public:
+    WorkQueue() { pthread_mutex_init(&m_lock, nullptr); }
+
+    ~WorkQueue()
+    {
+        VERIFY(m_size == 0);
+        free(m_tasks);
+        pthread_mutex_destroy(&m_lock);
+    }
+
+    // Takes over a reference to `task`.
+    ErrorOr<void> push(Task& task)
+    {
+        pthread_mutex_lock(&m_lock);
+        if (m_size == m_capacity) {
+            auto new_capacity = m_capacity ? m_capacity * 2 : 64;
+            auto* new_tasks = static_cast<Task**>(malloc(new_capacity * sizeof(Task*)));
+            if (!new_tasks) {
+                pthread_mutex_unlock(&m_lock);
+                return Error::from_errno(ENOMEM);
+            }
+            for (size_t i = 0; i < m_size; ++i)
+                new_tasks[i] = m_tasks[(m_head + i) % m_capacity];
+            free(m_tasks);
+            m_tasks = new_tasks;
+            m_capacity = new_capacity;
+            m_head = 0;
+        }
+        m_tasks[(m_head + m_size) % m_capacity] = &task;
+        atomic_store(&m_size, m_size + 1, memory_order_relaxed);
+        pthread_mutex_unlock(&m_lock);
+        return {};
+    }
+
+    RefPtr<Task> pop_back() { return take(false); }
+    RefPtr<Task> pop_front() { return take(true); }
+
+private:
+    RefPtr<Task> take(bool from_front)
+    {
+        if (atomic_load(&m_size, memory_order_relaxed) == 0)
+            return nullptr;
+
+        pthread_mutex_lock(&m_lock);
+        if (m_size == 0) {
+            pthread_mutex_unlock(&m_lock);
+            return nullptr;
+        }
+        Task* task = nullptr;
+        if (from_front) {
+            task = m_tasks[m_head];
+            m_head = (m_head + 1) % m_capacity;
+        } else {
+            task = m_tasks[(m_head + m_size - 1) % m_capacity];
+        }
+        atomic_store(&m_size, m_size - 1, memory_order_relaxed);
+        pthread_mutex_unlock(&m_lock);
+        return adopt_ref_if_nonnull(task);
+    }
+
+    pthread_mutex_t m_lock;
+    Task** m_tasks { nullptr };
+    size_t m_capacity { 0 };
+    size_t m_head { 0 };
+    size_t m_size { 0 };
+};
+
+// Queue 0 is shared by every thread outside the pool; each worker owns one of the others. Threads that run out of
+// work sleep on `m_wake` until a task is queued, or until the task they are joining finishes.
+class Pool {
+    AK_MAKE_NONCOPYABLE(Pool);
+    AK_MAKE_NONMOVABLE(Pool);
+
+public:
+    static ErrorOr<Pool*> create(size_t thread_count);
+    ~Pool();
+
+    size_t thread_count() const { return m_thread_count; }
+    size_t unfinished_task_count() const { return atomic_load(&m_unfinished, memory_order_acquire); }
+
+    ErrorOr<void> submit(NonnullRefPtr<Task> task);
+    void help_until_done(Task const& task);
+
+private:
+    explicit Pool(size_t thread_count);
+
+    static void* worker_entry(void* argument);
+    void run_worker(size_t queue_index);
+
+    size_t current_queue_index() const;
+    RefPtr<Task> take_task(size_t queue_index);
+    void run(Task& task);
+    void wait_for_work(Task const* awaited);
+    void wake_sleepers(bool everyone);
+
+    size_t m_thread_count { 0 };
+    WorkQueue* m_queues { nullptr };
+    pthread_t* m_workers { nullptr };
+    size_t m_started_workers { 0 };
+
+    size_t mutable m_queued { 0 };
+    size_t mutable m_unfinished { 0 };
+    size_t mutable m_sleepers { 0 };
+    bool m_stopping { false };
+    pthread_mutex_t m_sleep_lock;
+    pthread_cond_t m_wake;
+};
+
+struct WorkerStart {
+    Pool* pool;
+    size_t queue_index;
+};
+
+thread_local Pool* s_worker_pool { nullptr };
+thread_local size_t s_worker_queue_index { 0 };
+
+pthread_mutex_t s_pool_lock = PTHREAD_MUTEX_INITIALIZER;
+Pool* s_pool { nullptr };
+size_t s_requested_thread_count { 0 };
+
+size_t online_cpu_count()
+{
+    auto count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? static_cast<size_t>(count) : 1;
+}
+
+ErrorOr<Pool*> the_pool()
+{
+    if (auto* pool = atomic_load(&s_pool, memory_order_acquire))
+        return pool;
+
+    pthread_mutex_lock(&s_pool_lock);
+    auto* pool = s_pool;
+    if (!pool) {
+        auto pool_or_error = Pool::create(s_requested_thread_count ? s_requested_thread_count : online_cpu_count());
+        if (pool_or_error.is_error()) {
+            pthread_mutex_unlock(&s_pool_lock);
+            return pool_or_error.release_error();
+        }
+        pool = pool_or_error.release_value();
+        atomic_store(&s_pool, pool, memory_order_release);
+    }
+    pthread_mutex_unlock(&s_pool_lock);
+    return pool;
+}
+
+Pool::Pool(size_t thread_count)
+    : m_thread_count(thread_count)
+{
+    pthread_mutex_init(&m_sleep_lock, nullptr);
+    pthread_cond_init(&m_wake, nullptr);
+}
+
+ErrorOr<Pool*> Pool::create(size_t thread_count)
+{
+    auto* pool = new (nothrow) Pool(thread_count);
+    if (!pool)
+        return Error::from_errno(ENOMEM);
+
+    pool->m_queues = new (nothrow) WorkQueue[thread_count];
+    pool->m_workers = new (nothrow) pthread_t[thread_count];
+    if (!pool->m_queues || !pool->m_workers) {
+        delete pool;
+        return Error::from_errno(ENOMEM);
+    }
+
+    // The thread joining a task is the last of `thread_count`, so one worker fewer is started.
+    for (size_t index = 1; index < thread_count; ++index) {
+        auto* start = new (nothrow) WorkerStart { pool, index };
+        int rc = start ? pthread_create(&pool->m_workers[index - 1], nullptr, worker_entry, start) : ENOMEM;
+        if (rc != 0) {
+            delete start;
+            delete pool;
+            return Error::from_errno(rc);
+        }
+        ++pool->m_started_workers;
+    }
+    return pool;
+}
+
+Pool::~Pool()
+{
+    pthread_mutex_lock(&m_sleep_lock);
+    m_stopping = true;
+    pthread_cond_broadcast(&m_wake);
+    pthread_mutex_unlock(&m_sleep_lock);
+
+    for (size_t i = 0; i < m_started_workers; ++i)
+        pthread_join(m_workers[i], nullptr);
+
+    delete[] m_workers;
+    delete[] m_queues;
+    pthread_cond_destroy(&m_wake);
+    pthread_mutex_destroy(&m_sleep_lock);
+}
+
+void* Pool::worker_entry(void* argument)
+{
+    auto* start = static_cast<WorkerStart*>(argument);
+    auto* pool = start->pool;
+    auto queue_index = start->queue_index;
+    delete start;
+
+    s_worker_pool = pool;
+    s_worker_queue_index = queue_index;
+    pool->run_worker(queue_index);
+    return nullptr;
+}
+
+void Pool::run_worker(size_t queue_index)
+{
+    for (;;) {
+        if (auto task = take_task(queue_index)) {
+            run(*task);
+            continue;
+        }
+        pthread_mutex_lock(&m_sleep_lock);
+        bool stopping = m_stopping;
+        pthread_mutex_unlock(&m_sleep_lock);
+        if (stopping)
+            return;
+        wait_for_work(nullptr);
+    }
+}
+
+size_t Pool::current_queue_index() const
+{
+    return s_worker_pool == this ? s_worker_queue_index : 0;
+}
+
+ErrorOr<void> Pool::submit(NonnullRefPtr<Task> task)
+{
+    atomic_fetch_add<size_t>(&m_unfinished, 1);
+    auto& leaked_task = task.leak_ref();
+    auto result = m_queues[current_queue_index()].push(leaked_task);
+    if (result.is_error()) {
+        leaked_task.unref();
+        atomic_fetch_sub<size_t>(&m_unfinished, 1);
+        return result.release_error();
+    }
+    atomic_fetch_add<size_t>(&m_queued, 1);
+    wake_sleepers(false);
+    return {};
+}
+
+RefPtr<Task> Pool::take_task(size_t queue_index)
+{
+    if (atomic_load(&m_queued) == 0)
+        return nullptr;
+
+    auto task = m_queues[queue_index].pop_back();
+    for (size_t i = 1; !task && i < m_thread_count; ++i)
+        task = m_queues[(queue_index + i) % m_thread_count].pop_front();
+    if (task)
+        atomic_fetch_sub<size_t>(&m_queued, 1);
+    return task;
+}
+
+void Pool::run(Task& task)
+{
+    task.run();
+    atomic_fetch_sub<size_t>(&m_unfinished, 1, memory_order_release);
+    // Someone may be sleeping until this task finishes.
+    wake_sleepers(true);
+}
+
+void Pool::help_until_done(Task const& task)
+{
+    auto queue_index = current_queue_index();
+    while (!task.is_done()) {
+        if (auto other = take_task(queue_index)) {
+            run(*other);
+            continue;
+        }
+        wait_for_work(&task);
+    }
+}
+
+// A sleeper counts itself before checking for work, and a waker publishes its work before checking for sleepers,
+// so at least one of them sees the other: either the sleeper finds the work, or the waker takes the lock the
+// sleeper holds until it waits, and wakes it.
+void Pool::wait_for_work(Task const* awaited)
+{
+    pthread_mutex_lock(&m_sleep_lock);
+    atomic_fetch_add<size_t>(&m_sleepers, 1);
+    while (atomic_load(&m_queued) == 0 && !(awaited ? awaited->is_done() : m_stopping))
+        pthread_cond_wait(&m_wake, &m_sleep_lock);
+    atomic_fetch_sub<size_t>(&m_sleepers, 1);
+    pthread_mutex_unlock(&m_sleep_lock);
+}
+
+void Pool::wake_sleepers(bool everyone)
+{
+    if (atomic_load(&m_sleepers) == 0)
+        return;
+    pthread_mutex_lock(&m_sleep_lock);
+    if (everyone)
+        pthread_cond_broadcast(&m_wake);
+    else
+        pthread_cond_signal(&m_wake);
+    pthread_mutex_unlock(&m_sleep_lock);
+}
+
+}
+
+ErrorOr<NonnullRefPtr<Task>> Task::create(Function<ErrorOr<void>()> work)
+{
+    return adopt_nonnull_ref_or_enomem(new (nothrow) Task(move(work)));
+}
+
+void Task::run()
+{
+    auto result = m_work();
+    if (result.is_error())
+        m_error = result.release_error();
+    m_work = nullptr;
+    atomic_store(&m_done, true);
+}
+
+ErrorOr<void> Task::join() const
+{
+    if (!is_done())
+        TRY(the_pool())->help_until_done(*this);
+    if (m_error.has_value())
+        return m_error.value();
+    return {};
+}
+
+ErrorOr<NonnullRefPtr<Task>> spawn(Function<ErrorOr<void>()> work)
+{
+    auto* pool = TRY(the_pool());
+    auto task = TRY(Task::create(move(work)));
+    TRY(pool->submit(task));
+    return task;
+}
+
+ErrorOr<void> parallel_for(Range<size_t> range, size_t chunk, Function<ErrorOr<void>(size_t)> const& body)
+{
+    // The same indices as iterating `range`, in ascending order.
+    size_t begin = range.forwards ? range.start : range.end + 1;
+    size_t end = range.forwards ? range.end : range.start + 1;
+    if (range.is_inclusive) {
+        if (range.forwards)
+            ++end;
+        else
+            --begin;
+    }
+    if (begin >= end)
+        return {};
+
+    auto count = end - begin;
+    if (chunk == 0) {
+        chunk = count / (thread_count() * 4);
+        if (chunk == 0)
+            chunk = 1;
+    }
+
+    auto run_chunk = [&body](size_t first, size_t last) -> ErrorOr<void> {
+        for (size_t index = first; index < last; ++index)
+            TRY(body(index));
+        return {};
+    };
+
+    auto first_chunk_end = count <= chunk ? end : begin + chunk;
+    auto tasks = TRY(Array<NonnullRefPtr<Task>>::create_empty());
+    Optional<Error> error;
+    for (size_t first = first_chunk_end; first < end; first += min(chunk, end - first)) {
+        auto last = first + min(chunk, end - first);
+        auto task_or_error = spawn([&run_chunk, first, last]() { return run_chunk(first, last); });
+        if (task_or_error.is_error()) {
+            error = task_or_error.release_error();
+            break;
+        }
+        auto push_result = tasks.push(task_or_error.release_value());
+        if (push_result.is_error()) {
+            error = push_result.release_error();
+            break;
+        }
+    }
+
+    auto result = run_chunk(begin, first_chunk_end);
+    if (result.is_error() && !error.has_value())
+        error = result.release_error();
+
+    // Every spawned chunk refers to `body`, so all of them have to finish before returning, error or not.
+    for (size_t i = 0; i < tasks.size(); ++i) {
+        auto join_result = tasks[i]->join();
+        if (join_result.is_error() && !error.has_value())
+            error = join_result.release_error();
+    }
+
+    if (error.has_value())
+        return error.release_value();
+    return {};
+}
+
+size_t thread_count()
+{
+    if (auto* pool = atomic_load(&s_pool, memory_order_acquire))
+        return pool->thread_count();
+    pthread_mutex_lock(&s_pool_lock);
+    auto count = s_requested_thread_count ? s_requested_thread_count : online_cpu_count();
+    pthread_mutex_unlock(&s_pool_lock);
+    return count;
+}
+
+ErrorOr<void> set_thread_count(size_t count)
+{
+    if (count == 0)
+        return Error::from_errno(EINVAL);
+
+    pthread_mutex_lock(&s_pool_lock);
+    if (s_pool) {
+        if (s_pool->unfinished_task_count() != 0) {
+            pthread_mutex_unlock(&s_pool_lock);
+            return Error::from_errno(EBUSY);
+        }
+        delete s_pool;
+        atomic_store(&s_pool, static_cast<Pool*>(nullptr), memory_order_release);
+    }
+    s_requested_thread_count = count;
+    pthread_mutex_unlock(&s_pool_lock);
+    return {};
+}
+
+}
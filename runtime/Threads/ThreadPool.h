@@ -0,0 +1,67 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <Jakt/Error.h>
+#include <Jakt/Function.h>
+#include <Jakt/NonnullRefPtr.h>
+#include <Jakt/Optional.h>
+#include <Jakt/RefCounted.h>
+
+namespace JaktInternal {
+
+template<typename T>
+struct Range;
+
+// A unit of work handed to the thread pool by spawn(). Its state is shared between the thread that spawned it,
+// the thread that runs it and the threads that join it, so it always counts references atomically.
+class Task final : public AtomicRefCounted<Task> {
+public:
+    static ErrorOr<NonnullRefPtr<Task>> create(Function<ErrorOr<void>()> work);
+
+    // Waits for the task to finish, and returns the error it threw, if any. The waiting thread runs other queued
+    // tasks meanwhile, so joining from inside a task doesn't take a thread away from the pool.
+    ErrorOr<void> join() const;
+
+    bool is_done() const { return atomic_load(&m_done, memory_order_acquire); }
+
+    // Runs the work and drops it (and so its captures) before marking the task as done.
+    void run();
+
+private:
+    explicit Task(Function<ErrorOr<void>()> work)
+        : m_work(move(work))
+    {
+    }
+
+    Function<ErrorOr<void>()> m_work;
+    Optional<Error> m_error;
+    bool mutable m_done { false };
+};
+
+// Queues `work` on the process-wide work-stealing pool. A task spawned from inside another task is queued on
+// its worker's own queue, which that worker runs newest first; idle threads steal the oldest tasks of the others.
+ErrorOr<NonnullRefPtr<Task>> spawn(Function<ErrorOr<void>()> work);
+
+// Calls `body` with every index in `range`, `chunk` consecutive indices per task (0 picks a chunk that gives each
+// thread a few tasks), and returns once all of them have finished. The calling thread runs the first chunk itself.
+// If calls throw, one of their errors is returned.
+ErrorOr<void> parallel_for(Range<size_t> range, size_t chunk, Function<ErrorOr<void>(size_t)> const& body);
+
+// The number of threads running tasks, counting a thread that joins one. Defaults to the number of online CPUs.
+size_t thread_count();
+
+// Takes effect from the next spawn(). Fails with EBUSY while spawned tasks are still unfinished.
+ErrorOr<void> set_thread_count(size_t count);
+
+}
+
+namespace Jakt {
+using JaktInternal::parallel_for;
+using JaktInternal::set_thread_count;
+using JaktInternal::spawn;
+using JaktInternal::Task;
+using JaktInternal::thread_count;
+}
@@ -39,6 +39,7 @@
 #include <Jakt/StringView.h>
 #include <Jakt/Traits.h>
 #include <Jakt/Try.h>
+#include <Jakt/TaggedUnion.h>
 #include <Jakt/Tuple.h>
 #include <Jakt/TypeCasts.h>
 #include <Jakt/TypeList.h>
@@ -82,9 +83,15 @@ inline void panic(StringView message)
 
 [[noreturn]] inline void abort()
 {
+    flush_output();
     ::abort();
 }
 
+inline void flush()
+{
+    flush_output();
+}
+
 template<typename T>
 inline constexpr T unchecked_add(T value, T other)
 {
@@ -97,62 +104,77 @@ inline constexpr T unchecked_mul(T value, T other)
     return value * other;
 }
 
+// The panics are kept out of line and marked cold so the checks inline down to an overflow flag and a
+// not-taken branch.
+template<typename T>
+[[gnu::cold]] NEVER_INLINE void panic_on_overflow(char const* operation, char const* symbol, T value, T other)
+{
+    panic(MUST(String::formatted("Overflow in checked {} '{} {} {}'", operation, value, symbol, other)));
+}
+
 template<typename T>
-inline constexpr T checked_add(T value, T other)
+[[gnu::cold]] NEVER_INLINE void panic_on_division_by_zero(char const* operation, char const* symbol, T value, T other)
 {
-    Checked<T> checked = value;
-    checked += other;
-    if (checked.has_overflow())
-        panic(MUST(String::formatted("Overflow in checked addition '{} + {}'", value, other)));
-    return checked.value_unchecked();
+    panic(MUST(String::formatted("Division by zero in checked {} '{} {} {}'", operation, value, symbol, other)));
 }
 
 template<typename T>
-inline constexpr T checked_sub(T value, T other)
+ALWAYS_INLINE constexpr T checked_add(T value, T other)
 {
-    Checked<T> checked = value;
-    checked -= other;
-    if (checked.has_overflow())
-        panic(MUST(String::formatted("Overflow in checked subtraction '{} - {}'", value, other)));
-    return checked.value_unchecked();
+    T result;
+    if (__builtin_add_overflow(value, other, &result)) [[unlikely]]
+        panic_on_overflow("addition", "+", value, other);
+    return result;
 }
 
 template<typename T>
-inline constexpr T checked_mul(T value, T other)
+ALWAYS_INLINE constexpr T checked_sub(T value, T other)
 {
-    Checked<T> checked = value;
-    checked *= other;
-    if (checked.has_overflow())
-        panic(MUST(String::formatted("Overflow in checked multiplication '{} * {}'", value, other)));
-    return checked.value_unchecked();
+    T result;
+    if (__builtin_sub_overflow(value, other, &result)) [[unlikely]]
+        panic_on_overflow("subtraction", "-", value, other);
+    return result;
 }
 
 template<typename T>
-inline constexpr T checked_div(T value, T other)
+ALWAYS_INLINE constexpr T checked_mul(T value, T other)
 {
-    Checked<T> checked = value;
-    checked /= other;
-    if (checked.has_overflow()) {
-        if (other == 0)
-            panic(MUST(String::formatted("Division by zero in checked division '{} / {}'", value, other)));
-        else
-            panic(MUST(String::formatted("Overflow in checked division '{} / {}'", value, other)));
+    T result;
+    if (__builtin_mul_overflow(value, other, &result)) [[unlikely]]
+        panic_on_overflow("multiplication", "*", value, other);
+    return result;
+}
+
+template<typename T>
+ALWAYS_INLINE constexpr T checked_div(T value, T other)
+{
+    if (other == 0) [[unlikely]] {
+        panic_on_division_by_zero("division", "/", value, other);
+        return value;
     }
-    return checked.value_unchecked();
+    if constexpr (IsSigned<T>) {
+        if (value == NumericLimits<T>::min() && other == -1) [[unlikely]] {
+            panic_on_overflow("division", "/", value, other);
+            return value;
+        }
+    }
+    return value / other;
 }
 
 template<typename T>
-inline constexpr T checked_mod(T value, T other)
+ALWAYS_INLINE constexpr T checked_mod(T value, T other)
 {
-    Checked<T> checked = value;
-    checked %= other;
-    if (checked.has_overflow()) {
-        if (other == 0)
-            panic(MUST(String::formatted("Division by zero in checked modulo '{} % {}'", value, other)));
-        else
-            panic(MUST(String::formatted("Overflow in checked modulo '{} % {}'", value, other)));
+    if (other == 0) [[unlikely]] {
+        panic_on_division_by_zero("modulo", "%", value, other);
+        return value;
+    }
+    if constexpr (IsSigned<T>) {
+        if (value == NumericLimits<T>::min() && other == -1) [[unlikely]] {
+            panic_on_overflow("modulo", "%", value, other);
+            return value;
+        }
     }
-    return checked.value_unchecked();
+    return value % other;
 }
 
 template<typename T>
@@ -273,6 +295,38 @@ inline String ___jakt_get_target_triple_string()
 #endif
 }
 
+// Stack storage for a class instance that escape analysis proved never outlives the scope creating it.
+// The storage holds a reference of its own, so the object is never deleted through its refcount;
+// it is destroyed along with the storage instead.
+template<typename T>
+class LocalObject {
+    AK_MAKE_NONCOPYABLE(LocalObject);
+    AK_MAKE_NONMOVABLE(LocalObject);
+
+public:
+    LocalObject() = default;
+
+    ~LocalObject()
+    {
+        if (!m_object)
+            return;
+        m_object->release_last_ref();
+        m_object->~T();
+    }
+
+    template<typename... Args>
+    NonnullRefPtr<T> create(Args... args)
+    {
+        VERIFY(!m_object);
+        m_object = new (m_storage) T(move(args)...);
+        return NonnullRefPtr<T>(*m_object);
+    }
+
+private:
+    alignas(T) u8 m_storage[sizeof(T)];
+    T* m_object { nullptr };
+};
+
 template<typename T>
 struct _RemoveRefPtr {
     using Type = T;
@@ -295,10 +349,19 @@ ALWAYS_INLINE decltype(auto) deref_if_ref_pointer(T&& value)
         return static_cast<Conditional<IsRvalueReference<T>, RemoveReference<T>, T>>(value);
 }
 
+// Copies an argument bound to a `T const&` parameter when it refers to storage the callee could free
+// or reallocate while holding it.
+template<typename T>
+ALWAYS_INLINE RemoveCVReference<T> copy_argument(T&& value)
+{
+    return value;
+}
+
 }
 
 namespace Jakt {
 using JaktInternal::abort;
+using JaktInternal::flush;
 using JaktInternal::as_saturated;
 using JaktInternal::as_truncated;
 using JaktInternal::fallible_integer_cast;